@@ -0,0 +1,246 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "router.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    // Goal-directed engine: every query runs an A* search ordered by the route weight
+    // plus the heuristic lower bound of the remaining weight to the target.
+    // The heuristic has to be consistent: h(u, t) <= weight(u, v) + h(v, t) for every edge (u, v).
+    // Routes to many targets are found with one search from the source without the heuristic,
+    // stopped once all the targets are settled
+    template <typename Weight>
+    class AStarRouter final : public IRouter<Weight> {
+    private:
+        using Graph = CsrGraph<Weight>;
+
+    public:
+        using RouteInfo = typename IRouter<Weight>::RouteInfo;
+        using SearchStats = typename IRouter<Weight>::SearchStats;
+        using Heuristic = std::function<Weight(VertexId from, VertexId to)>;
+
+        AStarRouter(const Graph& graph, Heuristic heuristic);
+        // the copy searches its graph with the heuristic of the other router
+        AStarRouter(const Graph& graph, const AStarRouter& other);
+
+        std::unique_ptr<IRouter<Weight>> Clone(const Graph& graph) const override;
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, size_t& settled_vertices) const;
+        std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& targets) const override;
+
+        SearchStats GetSearchStats() const override;
+
+        // a consistent heuristic stays consistent with heavier or removed edges, so nothing is changed.
+        // Lighter and new edges or new vertices can break it, the engine is created again with a new one
+        bool UpdateEdges(const std::vector<EdgeId>& increased_edges, const std::vector<EdgeId>& decreased_edges) override;
+
+    private:
+        struct RouteInternalData {
+            Weight weight;
+            std::optional<EdgeId> prev_edge;
+        };
+
+        using RoutesInternalData = std::unordered_map<VertexId, RouteInternalData>;
+
+        std::optional<RouteInfo> ExtractRoute(const RoutesInternalData& routes_internal_data, VertexId to) const;
+
+        static constexpr Weight ZERO_WEIGHT{};
+        const Graph& graph_;
+        Heuristic heuristic_;
+        //the vertices the heuristic was made for
+        size_t vertex_count_;
+
+        mutable std::atomic<size_t> searches_count_{ 0 };
+        mutable std::atomic<size_t> settled_vertices_count_{ 0 };
+    };
+
+    template <typename Weight>
+    AStarRouter<Weight>::AStarRouter(const Graph& graph, Heuristic heuristic)
+        : graph_(graph)
+        , heuristic_(std::move(heuristic))
+        , vertex_count_(graph.GetVertexCount())
+    {
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    template <typename Weight>
+    AStarRouter<Weight>::AStarRouter(const Graph& graph, const AStarRouter& other)
+        : graph_(graph)
+        , heuristic_(other.heuristic_)
+        , vertex_count_(other.vertex_count_)
+    {
+    }
+
+    template <typename Weight>
+    std::unique_ptr<IRouter<Weight>> AStarRouter<Weight>::Clone(const Graph& graph) const {
+        return std::make_unique<AStarRouter>(graph, *this);
+    }
+
+    template <typename Weight>
+    std::optional<typename AStarRouter<Weight>::RouteInfo> AStarRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        size_t settled_vertices = 0;
+        return BuildRoute(from, to, settled_vertices);
+    }
+
+    template <typename Weight>
+    std::optional<typename AStarRouter<Weight>::RouteInfo> AStarRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to, size_t& settled_vertices) const {
+        using QueueItem = std::pair<Weight, VertexId>;
+
+        if (from >= graph_.GetVertexCount() || to >= graph_.GetVertexCount()) {
+            throw std::out_of_range("AStarRouter::BuildRoute: No such vertex");
+        }
+
+        RoutesInternalData routes_internal_data{
+            { from, RouteInternalData{ ZERO_WEIGHT, std::nullopt } }
+        };
+        std::unordered_set<VertexId> settled;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        queue.push({ heuristic_(from, to), from });
+
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (!settled.insert(vertex).second) {
+                continue;
+            }
+            if (vertex == to) {
+                break;
+            }
+
+            const Weight vertex_weight = routes_internal_data.at(vertex).weight;
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                if (settled.contains(arc.to)) {
+                    continue;
+                }
+                const Weight candidate_weight = vertex_weight + arc.weight;
+                auto [it, inserted] = routes_internal_data.emplace(arc.to, RouteInternalData{ candidate_weight, arc.edge_id });
+                if (inserted || candidate_weight < it->second.weight) {
+                    it->second = RouteInternalData{ candidate_weight, arc.edge_id };
+                    queue.push({ candidate_weight + heuristic_(arc.to, to), arc.to });
+                }
+            }
+        }
+
+        settled_vertices = settled.size();
+        searches_count_.fetch_add(1, std::memory_order_relaxed);
+        settled_vertices_count_.fetch_add(settled_vertices, std::memory_order_relaxed);
+
+        if (!settled.contains(to)) {
+            return std::nullopt;
+        }
+
+        return ExtractRoute(routes_internal_data, to);
+    }
+
+    template <typename Weight>
+    std::vector<std::optional<typename AStarRouter<Weight>::RouteInfo>> AStarRouter<Weight>::BuildRoutes(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        using QueueItem = std::pair<Weight, VertexId>;
+
+        if (targets.size() < 2) {
+            return IRouter<Weight>::BuildRoutes(from, targets);
+        }
+        if (from >= graph_.GetVertexCount()) {
+            throw std::out_of_range("AStarRouter::BuildRoutes: No such vertex");
+        }
+
+        std::unordered_set<VertexId> remaining_targets;
+        for (const VertexId to : targets) {
+            if (to >= graph_.GetVertexCount()) {
+                throw std::out_of_range("AStarRouter::BuildRoutes: No such vertex");
+            }
+            remaining_targets.insert(to);
+        }
+
+        RoutesInternalData routes_internal_data{
+            { from, RouteInternalData{ ZERO_WEIGHT, std::nullopt } }
+        };
+        std::unordered_set<VertexId> settled;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        queue.push({ ZERO_WEIGHT, from });
+
+        while (!queue.empty() && !remaining_targets.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (!settled.insert(vertex).second) {
+                continue;
+            }
+            remaining_targets.erase(vertex);
+
+            const Weight vertex_weight = routes_internal_data.at(vertex).weight;
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                if (settled.contains(arc.to)) {
+                    continue;
+                }
+                const Weight candidate_weight = vertex_weight + arc.weight;
+                auto [it, inserted] = routes_internal_data.emplace(arc.to, RouteInternalData{ candidate_weight, arc.edge_id });
+                if (inserted || candidate_weight < it->second.weight) {
+                    it->second = RouteInternalData{ candidate_weight, arc.edge_id };
+                    queue.push({ candidate_weight, arc.to });
+                }
+            }
+        }
+
+        searches_count_.fetch_add(1, std::memory_order_relaxed);
+        settled_vertices_count_.fetch_add(settled.size(), std::memory_order_relaxed);
+
+        std::vector<std::optional<RouteInfo>> routes;
+        routes.reserve(targets.size());
+        for (const VertexId to : targets) {
+            routes.push_back(settled.contains(to) ? ExtractRoute(routes_internal_data, to) : std::nullopt);
+        }
+        return routes;
+    }
+
+    template <typename Weight>
+    std::optional<typename AStarRouter<Weight>::RouteInfo> AStarRouter<Weight>::ExtractRoute(
+        const RoutesInternalData& routes_internal_data, VertexId to) const {
+        const Weight weight = routes_internal_data.at(to).weight;
+        std::vector<EdgeId> edges;
+        for (std::optional<EdgeId> edge_id = routes_internal_data.at(to).prev_edge;
+            edge_id;
+            edge_id = routes_internal_data.at(graph_.GetEdge(*edge_id).from).prev_edge)
+        {
+            edges.push_back(*edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        return RouteInfo{ weight, std::move(edges) };
+    }
+
+    template <typename Weight>
+    typename AStarRouter<Weight>::SearchStats AStarRouter<Weight>::GetSearchStats() const {
+        return SearchStats{
+            .searches_count = searches_count_.load(std::memory_order_relaxed)
+            , .settled_vertices_count = settled_vertices_count_.load(std::memory_order_relaxed)
+        };
+    }
+
+    template <typename Weight>
+    bool AStarRouter<Weight>::UpdateEdges([[maybe_unused]] const std::vector<EdgeId>& increased_edges
+        , const std::vector<EdgeId>& decreased_edges) {
+        return decreased_edges.empty() && graph_.GetVertexCount() == vertex_count_;
+    }
+
+}  // namespace graph
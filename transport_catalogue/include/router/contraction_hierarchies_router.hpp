@@ -0,0 +1,558 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "router.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    // Contraction Hierarchies engine: vertices are contracted one by one in the constructor,
+    // shortcuts keep the pair of edges they replace, so the found route can be unpacked
+    // back into the edges of the original graph.
+    // Queries are answered with a bidirectional search going only upward in the hierarchy.
+    template <typename Weight>
+    class ContractionHierarchiesRouter final : public IRouter<Weight> {
+    private:
+        using Graph = CsrGraph<Weight>;
+
+    public:
+        using RouteInfo = typename IRouter<Weight>::RouteInfo;
+        using PackedId = uint32_t;
+
+        // a contracted edge as it's saved: an edge of the graph or a shortcut of two earlier edges
+        struct PackedEdge {
+            Weight weight;
+            PackedId from;
+            PackedId to;
+            PackedId original_edge; //NO_EDGE for shortcuts
+            PackedId first_child;
+            PackedId second_child;
+            PackedId reserved; //keeps the record free of padding
+        };
+
+        // the contracted edges in the order they were added and the rank of every vertex
+        struct Hierarchy {
+            std::span<const PackedEdge> edges;
+            std::span<const PackedId> ranks;
+        };
+
+        static constexpr PackedId NO_EDGE = std::numeric_limits<PackedId>::max();
+
+        explicit ContractionHierarchiesRouter(const Graph& graph);
+        // the saved hierarchy is copied, only the search graphs are built again. O(E)
+        ContractionHierarchiesRouter(const Graph& graph, Hierarchy hierarchy);
+
+        // the hierarchy doesn't refer to the graph, so the copy is a plain copy of it
+        std::unique_ptr<IRouter<Weight>> Clone(const Graph& graph) const override;
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+        std::vector<PackedEdge> GetPackedEdges() const;
+        std::vector<PackedId> GetPackedRanks() const;
+        // checks a hierarchy of an untrusted source, e.g. a file: the edges of the graph are
+        // the ones of the graph and a shortcut joins the two earlier edges it's the sum of,
+        // so BuildRoute can neither leave the arrays nor loop while unpacking. O(E)
+        static bool IsValidHierarchy(const Graph& graph, Hierarchy hierarchy);
+
+    private:
+        using ContractedEdgeId = size_t;
+
+        struct ContractedEdge {
+            VertexId from;
+            VertexId to;
+            Weight weight;
+            std::optional<EdgeId> original_edge; //nullopt for shortcuts
+            ContractedEdgeId first_child;
+            ContractedEdgeId second_child;
+        };
+
+        struct Shortcut {
+            ContractedEdgeId in_edge;
+            ContractedEdgeId out_edge;
+        };
+
+        using QueueItem = std::pair<Weight, VertexId>;
+        using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+        struct SearchData {
+            Weight weight;
+            std::optional<ContractedEdgeId> prev_edge;
+        };
+        using SearchSpace = std::unordered_map<VertexId, SearchData>;
+
+        //preprocessing
+        void AddOriginalEdges(const Graph& graph);
+        ContractedEdgeId AddContractedEdge(ContractedEdge&& edge);
+        void ContractVertices();
+        std::vector<Shortcut> FindShortcuts(VertexId vertex) const;
+        int ComputePriority(VertexId vertex) const;
+        void ContractVertex(VertexId vertex);
+        std::unordered_map<VertexId, Weight> RunWitnessSearch(VertexId source, VertexId excluded
+            , Weight max_weight) const;
+        void BuildSearchGraphs();
+
+        //queries
+        void RunSearchStep(Queue& queue, SearchSpace& space, const SearchSpace& opposite_space
+            , const std::vector<size_t>& offsets, const std::vector<ContractedEdgeId>& edges
+            , bool forward, std::optional<std::pair<Weight, VertexId>>& best) const;
+        void UnpackEdge(ContractedEdgeId edge_id, std::vector<EdgeId>& edges) const;
+
+        static constexpr Weight ZERO_WEIGHT{};
+        static constexpr size_t WITNESS_SETTLED_LIMIT = 500;
+
+        size_t vertex_count_;
+        std::vector<ContractedEdge> edges_;
+        std::vector<size_t> ranks_;
+
+        //work lists, used only while the hierarchy is being built
+        std::vector<std::vector<ContractedEdgeId>> out_edges_;
+        std::vector<std::vector<ContractedEdgeId>> in_edges_;
+        std::vector<bool> contracted_;
+        std::vector<int> contracted_neighbours_;
+
+        //search graphs in compressed form: edges going up from a vertex
+        //and edges coming down to a vertex (walked backward by the search from the target)
+        std::vector<size_t> upward_offsets_;
+        std::vector<ContractedEdgeId> upward_edges_;
+        std::vector<size_t> downward_offsets_;
+        std::vector<ContractedEdgeId> downward_edges_;
+    };
+
+    template <typename Weight>
+    ContractionHierarchiesRouter<Weight>::ContractionHierarchiesRouter(const Graph& graph)
+        : vertex_count_(graph.GetVertexCount())
+        , ranks_(graph.GetVertexCount(), 0)
+        , out_edges_(graph.GetVertexCount())
+        , in_edges_(graph.GetVertexCount())
+        , contracted_(graph.GetVertexCount(), false)
+        , contracted_neighbours_(graph.GetVertexCount(), 0)
+    {
+        AddOriginalEdges(graph);
+        ContractVertices();
+        BuildSearchGraphs();
+
+        out_edges_ = {};
+        in_edges_ = {};
+        contracted_ = {};
+        contracted_neighbours_ = {};
+    }
+
+    template <typename Weight>
+    ContractionHierarchiesRouter<Weight>::ContractionHierarchiesRouter(const Graph& graph, Hierarchy hierarchy)
+        : vertex_count_(graph.GetVertexCount())
+        , ranks_(hierarchy.ranks.begin(), hierarchy.ranks.end())
+    {
+        if (ranks_.size() != vertex_count_) {
+            throw std::length_error("The hierarchy doesn't match the graph");
+        }
+        edges_.reserve(hierarchy.edges.size());
+        for (const PackedEdge& edge : hierarchy.edges) {
+            edges_.push_back(ContractedEdge{
+                edge.from
+                , edge.to
+                , edge.weight
+                , edge.original_edge == NO_EDGE ? std::nullopt : std::optional<EdgeId>{ edge.original_edge }
+                , edge.first_child
+                , edge.second_child
+            });
+        }
+        BuildSearchGraphs();
+    }
+
+    template <typename Weight>
+    std::vector<typename ContractionHierarchiesRouter<Weight>::PackedEdge>
+        ContractionHierarchiesRouter<Weight>::GetPackedEdges() const {
+        if (edges_.size() >= NO_EDGE || vertex_count_ >= NO_EDGE) {
+            throw std::length_error("The hierarchy is too large to be packed");
+        }
+        std::vector<PackedEdge> packed_edges;
+        packed_edges.reserve(edges_.size());
+        for (const ContractedEdge& edge : edges_) {
+            packed_edges.push_back(PackedEdge{
+                .weight = edge.weight
+                , .from = static_cast<PackedId>(edge.from)
+                , .to = static_cast<PackedId>(edge.to)
+                , .original_edge = edge.original_edge ? static_cast<PackedId>(*edge.original_edge) : NO_EDGE
+                , .first_child = static_cast<PackedId>(edge.first_child)
+                , .second_child = static_cast<PackedId>(edge.second_child)
+                , .reserved = 0
+            });
+        }
+        return packed_edges;
+    }
+
+    template <typename Weight>
+    std::vector<typename ContractionHierarchiesRouter<Weight>::PackedId>
+        ContractionHierarchiesRouter<Weight>::GetPackedRanks() const {
+        return std::vector<PackedId>(ranks_.begin(), ranks_.end());
+    }
+
+    template <typename Weight>
+    bool ContractionHierarchiesRouter<Weight>::IsValidHierarchy(const Graph& graph, Hierarchy hierarchy) {
+        if (hierarchy.ranks.size() != graph.GetVertexCount() || hierarchy.edges.size() >= NO_EDGE) {
+            return false;
+        }
+        for (size_t edge_id = 0; edge_id < hierarchy.edges.size(); ++edge_id) {
+            const PackedEdge& edge = hierarchy.edges[edge_id];
+            if (edge.from >= graph.GetVertexCount() || edge.to >= graph.GetVertexCount()) {
+                return false;
+            }
+            if (edge.original_edge != NO_EDGE) {
+                if (edge.original_edge >= graph.GetEdgeCount()) {
+                    return false;
+                }
+                const Edge<Weight>& original_edge = graph.GetEdge(edge.original_edge);
+                if (original_edge.from != edge.from || original_edge.to != edge.to
+                    || original_edge.weight != edge.weight || edge.weight < ZERO_WEIGHT) {
+                    return false;
+                }
+                continue;
+            }
+            //the children are added before the shortcut, so unpacking always goes back in the array
+            if (edge.first_child >= edge_id || edge.second_child >= edge_id) {
+                return false;
+            }
+            const PackedEdge& first_child = hierarchy.edges[edge.first_child];
+            const PackedEdge& second_child = hierarchy.edges[edge.second_child];
+            if (first_child.from != edge.from || first_child.to != second_child.from || second_child.to != edge.to
+                || first_child.weight + second_child.weight != edge.weight) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Weight>
+    std::unique_ptr<IRouter<Weight>> ContractionHierarchiesRouter<Weight>::Clone([[maybe_unused]] const Graph& graph) const {
+        return std::make_unique<ContractionHierarchiesRouter>(*this);
+    }
+
+    template <typename Weight>
+    void ContractionHierarchiesRouter<Weight>::AddOriginalEdges(const Graph& graph) {
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            //only the lightest of parallel edges can be a part of a shortest route
+            std::unordered_map<VertexId, EdgeId> lightest_edges;
+            for (const auto& arc : graph.GetArcs(vertex)) {
+                if (arc.weight < ZERO_WEIGHT) {
+                    throw std::domain_error("Edges' weights should be non-negative");
+                }
+                if (arc.to == vertex) {
+                    continue;
+                }
+                auto [it, inserted] = lightest_edges.emplace(arc.to, arc.edge_id);
+                if (!inserted && arc.weight < graph.GetEdge(it->second).weight) {
+                    it->second = arc.edge_id;
+                }
+            }
+
+            std::vector<EdgeId> edge_ids;
+            edge_ids.reserve(lightest_edges.size());
+            for (const auto& [to, edge_id] : lightest_edges) {
+                edge_ids.push_back(edge_id);
+            }
+            std::sort(edge_ids.begin(), edge_ids.end());
+
+            for (const EdgeId edge_id : edge_ids) {
+                const auto& edge = graph.GetEdge(edge_id);
+                AddContractedEdge({ edge.from, edge.to, edge.weight, edge_id, 0, 0 });
+            }
+        }
+    }
+
+    template <typename Weight>
+    typename ContractionHierarchiesRouter<Weight>::ContractedEdgeId
+        ContractionHierarchiesRouter<Weight>::AddContractedEdge(ContractedEdge&& edge) {
+        const ContractedEdgeId id = edges_.size();
+        out_edges_[edge.from].push_back(id);
+        in_edges_[edge.to].push_back(id);
+        edges_.push_back(std::move(edge));
+        return id;
+    }
+
+    template <typename Weight>
+    void ContractionHierarchiesRouter<Weight>::ContractVertices() {
+        using PriorityItem = std::pair<int, VertexId>;
+        std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> queue;
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            queue.push({ ComputePriority(vertex), vertex });
+        }
+
+        size_t next_rank = 0;
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+
+            //lazy update: priorities of the queued vertices can become stale after contractions
+            const int priority = ComputePriority(vertex);
+            if (!queue.empty() && priority > queue.top().first) {
+                queue.push({ priority, vertex });
+                continue;
+            }
+
+            ContractVertex(vertex);
+            ranks_[vertex] = next_rank++;
+        }
+    }
+
+    template <typename Weight>
+    std::vector<typename ContractionHierarchiesRouter<Weight>::Shortcut>
+        ContractionHierarchiesRouter<Weight>::FindShortcuts(VertexId vertex) const {
+        std::vector<Shortcut> shortcuts;
+
+        Weight max_out_weight = ZERO_WEIGHT;
+        for (const ContractedEdgeId out_id : out_edges_[vertex]) {
+            if (!contracted_[edges_[out_id].to]) {
+                max_out_weight = std::max(max_out_weight, edges_[out_id].weight);
+            }
+        }
+
+        for (const ContractedEdgeId in_id : in_edges_[vertex]) {
+            const ContractedEdge& in_edge = edges_[in_id];
+            if (contracted_[in_edge.from]) {
+                continue;
+            }
+
+            const auto witnesses = RunWitnessSearch(in_edge.from, vertex, in_edge.weight + max_out_weight);
+            for (const ContractedEdgeId out_id : out_edges_[vertex]) {
+                const ContractedEdge& out_edge = edges_[out_id];
+                if (contracted_[out_edge.to] || out_edge.to == in_edge.from) {
+                    continue;
+                }
+
+                const Weight shortcut_weight = in_edge.weight + out_edge.weight;
+                if (auto it = witnesses.find(out_edge.to); it != witnesses.end() && !(shortcut_weight < it->second)) {
+                    continue;
+                }
+                shortcuts.push_back({ in_id, out_id });
+            }
+        }
+
+        return shortcuts;
+    }
+
+    template <typename Weight>
+    int ContractionHierarchiesRouter<Weight>::ComputePriority(VertexId vertex) const {
+        int removed_edges = 0;
+        for (const ContractedEdgeId in_id : in_edges_[vertex]) {
+            removed_edges += contracted_[edges_[in_id].from] ? 0 : 1;
+        }
+        for (const ContractedEdgeId out_id : out_edges_[vertex]) {
+            removed_edges += contracted_[edges_[out_id].to] ? 0 : 1;
+        }
+        const int added_edges = static_cast<int>(FindShortcuts(vertex).size());
+
+        return added_edges - removed_edges + contracted_neighbours_[vertex];
+    }
+
+    template <typename Weight>
+    void ContractionHierarchiesRouter<Weight>::ContractVertex(VertexId vertex) {
+        for (const Shortcut& shortcut : FindShortcuts(vertex)) {
+            const ContractedEdge& in_edge = edges_[shortcut.in_edge];
+            const ContractedEdge& out_edge = edges_[shortcut.out_edge];
+            AddContractedEdge({
+                in_edge.from
+                , out_edge.to
+                , in_edge.weight + out_edge.weight
+                , std::nullopt
+                , shortcut.in_edge
+                , shortcut.out_edge
+            });
+        }
+
+        contracted_[vertex] = true;
+        for (const ContractedEdgeId in_id : in_edges_[vertex]) {
+            ++contracted_neighbours_[edges_[in_id].from];
+        }
+        for (const ContractedEdgeId out_id : out_edges_[vertex]) {
+            ++contracted_neighbours_[edges_[out_id].to];
+        }
+    }
+
+    template <typename Weight>
+    std::unordered_map<VertexId, Weight> ContractionHierarchiesRouter<Weight>::RunWitnessSearch(
+        VertexId source, VertexId excluded, Weight max_weight) const {
+        std::unordered_map<VertexId, Weight> weights{ { source, ZERO_WEIGHT } };
+        std::unordered_set<VertexId> settled;
+        Queue queue;
+        queue.push({ ZERO_WEIGHT, source });
+
+        //the search is bounded, a witness that was not found only costs an extra shortcut
+        while (!queue.empty() && settled.size() < WITNESS_SETTLED_LIMIT) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (max_weight < weight) {
+                break;
+            }
+            if (!settled.insert(vertex).second) {
+                continue;
+            }
+
+            for (const ContractedEdgeId edge_id : out_edges_[vertex]) {
+                const ContractedEdge& edge = edges_[edge_id];
+                if (edge.to == excluded || contracted_[edge.to]) {
+                    continue;
+                }
+                const Weight candidate_weight = weight + edge.weight;
+                auto [it, inserted] = weights.emplace(edge.to, candidate_weight);
+                if (inserted || candidate_weight < it->second) {
+                    it->second = candidate_weight;
+                    queue.push({ candidate_weight, edge.to });
+                }
+            }
+        }
+
+        return weights;
+    }
+
+    template <typename Weight>
+    void ContractionHierarchiesRouter<Weight>::BuildSearchGraphs() {
+        upward_offsets_.assign(vertex_count_ + 1, 0);
+        downward_offsets_.assign(vertex_count_ + 1, 0);
+        for (const ContractedEdge& edge : edges_) {
+            if (ranks_[edge.from] < ranks_[edge.to]) {
+                ++upward_offsets_[edge.from + 1];
+            }
+            else {
+                ++downward_offsets_[edge.to + 1];
+            }
+        }
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            upward_offsets_[vertex + 1] += upward_offsets_[vertex];
+            downward_offsets_[vertex + 1] += downward_offsets_[vertex];
+        }
+
+        upward_edges_.resize(upward_offsets_.back());
+        downward_edges_.resize(downward_offsets_.back());
+        std::vector<size_t> upward_positions(upward_offsets_.begin(), std::prev(upward_offsets_.end()));
+        std::vector<size_t> downward_positions(downward_offsets_.begin(), std::prev(downward_offsets_.end()));
+        for (ContractedEdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+            const ContractedEdge& edge = edges_[edge_id];
+            if (ranks_[edge.from] < ranks_[edge.to]) {
+                upward_edges_[upward_positions[edge.from]++] = edge_id;
+            }
+            else {
+                downward_edges_[downward_positions[edge.to]++] = edge_id;
+            }
+        }
+    }
+
+    template <typename Weight>
+    std::optional<typename ContractionHierarchiesRouter<Weight>::RouteInfo>
+        ContractionHierarchiesRouter<Weight>::BuildRoute(VertexId from, VertexId to) const {
+        if (from >= vertex_count_ || to >= vertex_count_) {
+            throw std::out_of_range("ContractionHierarchiesRouter::BuildRoute: No such vertex");
+        }
+
+        SearchSpace forward_space{ { from, SearchData{ ZERO_WEIGHT, std::nullopt } } };
+        SearchSpace backward_space{ { to, SearchData{ ZERO_WEIGHT, std::nullopt } } };
+        Queue forward_queue;
+        Queue backward_queue;
+        forward_queue.push({ ZERO_WEIGHT, from });
+        backward_queue.push({ ZERO_WEIGHT, to });
+
+        //weight of the best route found so far and the vertex where both searches met on it
+        std::optional<std::pair<Weight, VertexId>> best;
+        if (from == to) {
+            best = { ZERO_WEIGHT, from };
+        }
+
+        auto is_search_finished = [&best](const Queue& queue) {
+            return queue.empty() || (best && !(queue.top().first < best->first));
+        };
+        while (!is_search_finished(forward_queue) || !is_search_finished(backward_queue)) {
+            if (!is_search_finished(forward_queue)) {
+                RunSearchStep(forward_queue, forward_space, backward_space
+                    , upward_offsets_, upward_edges_, true, best);
+            }
+            if (!is_search_finished(backward_queue)) {
+                RunSearchStep(backward_queue, backward_space, forward_space
+                    , downward_offsets_, downward_edges_, false, best);
+            }
+        }
+
+        if (!best) {
+            return std::nullopt;
+        }
+
+        std::vector<ContractedEdgeId> contracted_edges;
+        for (std::optional<ContractedEdgeId> edge_id = forward_space.at(best->second).prev_edge;
+            edge_id;
+            edge_id = forward_space.at(edges_[*edge_id].from).prev_edge)
+        {
+            contracted_edges.push_back(*edge_id);
+        }
+        std::reverse(contracted_edges.begin(), contracted_edges.end());
+        for (std::optional<ContractedEdgeId> edge_id = backward_space.at(best->second).prev_edge;
+            edge_id;
+            edge_id = backward_space.at(edges_[*edge_id].to).prev_edge)
+        {
+            contracted_edges.push_back(*edge_id);
+        }
+
+        std::vector<EdgeId> edges;
+        for (const ContractedEdgeId edge_id : contracted_edges) {
+            UnpackEdge(edge_id, edges);
+        }
+
+        return RouteInfo{ best->first, std::move(edges) };
+    }
+
+    template <typename Weight>
+    void ContractionHierarchiesRouter<Weight>::RunSearchStep(Queue& queue, SearchSpace& space, const SearchSpace& opposite_space
+        , const std::vector<size_t>& offsets, const std::vector<ContractedEdgeId>& edges
+        , bool forward, std::optional<std::pair<Weight, VertexId>>& best) const {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (space.at(vertex).weight < weight) {
+            return;
+        }
+
+        if (auto it = opposite_space.find(vertex); it != opposite_space.end()) {
+            const Weight route_weight = weight + it->second.weight;
+            if (!best || route_weight < best->first) {
+                best = { route_weight, vertex };
+            }
+        }
+
+        for (size_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+            const ContractedEdge& edge = edges_[edges[i]];
+            const VertexId next_vertex = forward ? edge.to : edge.from;
+            const Weight candidate_weight = weight + edge.weight;
+            auto [it, inserted] = space.emplace(next_vertex, SearchData{ candidate_weight, edges[i] });
+            if (inserted || candidate_weight < it->second.weight) {
+                it->second = SearchData{ candidate_weight, edges[i] };
+                queue.push({ candidate_weight, next_vertex });
+            }
+        }
+    }
+
+    template <typename Weight>
+    void ContractionHierarchiesRouter<Weight>::UnpackEdge(ContractedEdgeId edge_id, std::vector<EdgeId>& edges) const {
+        std::vector<ContractedEdgeId> stack{ edge_id };
+        while (!stack.empty()) {
+            const ContractedEdge& edge = edges_[stack.back()];
+            stack.pop_back();
+            if (edge.original_edge) {
+                edges.push_back(*edge.original_edge);
+                continue;
+            }
+            stack.push_back(edge.second_child);
+            stack.push_back(edge.first_child);
+        }
+    }
+
+}  // namespace graph
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "graph.hpp"
+#include "ranges.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+namespace graph {
+
+    // Frozen compressed sparse row form of DirectedWeightedGraph, built once the graph is complete.
+    // Outgoing arcs of all vertices are packed into one array ordered by the source vertex,
+    // so routing engines walk them without bounds checks and per-vertex allocations.
+    // Incremental updates keep the ids of the edges: a removed edge stays in the edges array,
+    // only its arc is dropped
+    template <typename Weight>
+    class CsrGraph {
+    public:
+        struct Arc {
+            VertexId to;
+            Weight weight;
+            EdgeId edge_id;
+        };
+
+    private:
+        using ArcsRange = ranges::Range<const Arc*>;
+
+    public:
+        CsrGraph() = default;
+        explicit CsrGraph(const DirectedWeightedGraph<Weight>& graph);
+        // restores a graph from the arrays given out by GetOffsets, GetArcsArray and GetEdges
+        CsrGraph(std::span<const size_t> offsets, std::span<const Arc> arcs, std::span<const Edge<Weight>> edges);
+
+        size_t GetVertexCount() const;
+        size_t GetEdgeCount() const;
+
+        // no bounds checks: the ids have to be less than the vertex and edge counts
+        ArcsRange GetArcs(VertexId vertex) const;
+        const Edge<Weight>& GetEdge(EdgeId edge_id) const;
+
+        std::span<const size_t> GetOffsets() const;
+        std::span<const Arc> GetArcsArray() const;
+        std::span<const Edge<Weight>> GetEdges() const;
+
+        void SetEdgeWeight(EdgeId edge_id, Weight weight);
+        // the new edges take the ids after the present ones, the vertex count can only grow
+        void AddEdges(const std::vector<Edge<Weight>>& edges, size_t vertex_count);
+        void RemoveEdges(const std::vector<EdgeId>& edge_ids);
+
+    private:
+        std::vector<size_t> offsets_;
+        std::vector<Arc> arcs_;
+        std::vector<Edge<Weight>> edges_;
+    };
+
+    template <typename Weight>
+    CsrGraph<Weight>::CsrGraph(const DirectedWeightedGraph<Weight>& graph)
+        : offsets_(graph.GetVertexCount() + 1, 0)
+    {
+        arcs_.reserve(graph.GetEdgeCount());
+        edges_.reserve(graph.GetEdgeCount());
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            edges_.push_back(graph.GetEdge(edge_id));
+        }
+
+        for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const Edge<Weight>& edge = edges_[edge_id];
+                arcs_.push_back(Arc{ edge.to, edge.weight, edge_id });
+            }
+            offsets_[vertex + 1] = arcs_.size();
+        }
+    }
+
+    template <typename Weight>
+    CsrGraph<Weight>::CsrGraph(std::span<const size_t> offsets, std::span<const Arc> arcs
+        , std::span<const Edge<Weight>> edges)
+        : offsets_(offsets.begin(), offsets.end())
+        , arcs_(arcs.begin(), arcs.end())
+        , edges_(edges.begin(), edges.end())
+    {
+    }
+
+    template <typename Weight>
+    size_t CsrGraph<Weight>::GetVertexCount() const {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    template <typename Weight>
+    size_t CsrGraph<Weight>::GetEdgeCount() const {
+        return edges_.size();
+    }
+
+    template <typename Weight>
+    typename CsrGraph<Weight>::ArcsRange CsrGraph<Weight>::GetArcs(VertexId vertex) const {
+        return ArcsRange{ arcs_.data() + offsets_[vertex], arcs_.data() + offsets_[vertex + 1] };
+    }
+
+    template <typename Weight>
+    const Edge<Weight>& CsrGraph<Weight>::GetEdge(EdgeId edge_id) const {
+        return edges_[edge_id];
+    }
+
+    template <typename Weight>
+    std::span<const size_t> CsrGraph<Weight>::GetOffsets() const {
+        return offsets_;
+    }
+
+    template <typename Weight>
+    std::span<const typename CsrGraph<Weight>::Arc> CsrGraph<Weight>::GetArcsArray() const {
+        return arcs_;
+    }
+
+    template <typename Weight>
+    std::span<const Edge<Weight>> CsrGraph<Weight>::GetEdges() const {
+        return edges_;
+    }
+
+    template <typename Weight>
+    void CsrGraph<Weight>::SetEdgeWeight(EdgeId edge_id, Weight weight) {
+        Edge<Weight>& edge = edges_.at(edge_id);
+        edge.weight = weight;
+        for (size_t arc_id = offsets_[edge.from]; arc_id < offsets_[edge.from + 1]; ++arc_id) {
+            if (arcs_[arc_id].edge_id == edge_id) {
+                arcs_[arc_id].weight = weight;
+            }
+        }
+    }
+
+    template <typename Weight>
+    void CsrGraph<Weight>::AddEdges(const std::vector<Edge<Weight>>& edges, size_t vertex_count) {
+        const size_t old_vertex_count = GetVertexCount();
+        vertex_count = std::max(vertex_count, old_vertex_count);
+
+        std::vector<size_t> offsets(vertex_count + 1, 0);
+        for (VertexId vertex = 0; vertex < old_vertex_count; ++vertex) {
+            offsets[vertex + 1] = offsets_[vertex + 1] - offsets_[vertex];
+        }
+        for (const Edge<Weight>& edge : edges) {
+            ++offsets.at(edge.from + 1);
+        }
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            offsets[vertex + 1] += offsets[vertex];
+        }
+
+        std::vector<Arc> arcs(offsets.back());
+        std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+        for (VertexId vertex = 0; vertex < old_vertex_count; ++vertex) {
+            for (const Arc& arc : GetArcs(vertex)) {
+                arcs[positions[vertex]++] = arc;
+            }
+        }
+        for (const Edge<Weight>& edge : edges) {
+            arcs[positions[edge.from]++] = Arc{ edge.to, edge.weight, edges_.size() };
+            edges_.push_back(edge);
+        }
+
+        offsets_ = std::move(offsets);
+        arcs_ = std::move(arcs);
+    }
+
+    template <typename Weight>
+    void CsrGraph<Weight>::RemoveEdges(const std::vector<EdgeId>& edge_ids) {
+        std::vector<bool> removed(edges_.size(), false);
+        for (const EdgeId edge_id : edge_ids) {
+            removed.at(edge_id) = true;
+        }
+
+        size_t arcs_count = 0;
+        for (VertexId vertex = 0; vertex < GetVertexCount(); ++vertex) {
+            const size_t begin = offsets_[vertex];
+            offsets_[vertex] = arcs_count;
+            for (size_t arc_id = begin; arc_id < offsets_[vertex + 1]; ++arc_id) {
+                if (!removed[arcs_[arc_id].edge_id]) {
+                    arcs_[arcs_count++] = arcs_[arc_id];
+                }
+            }
+        }
+        offsets_.back() = arcs_count;
+        arcs_.resize(arcs_count);
+    }
+
+}  // namespace graph
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "router.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    // Lazy single-source engine: a shortest-path tree is built with Dijkstra's algorithm
+    // on the first query from a source vertex and memoized for all the next ones.
+    // An update of the graph drops only the trees it can change
+    template <typename Weight>
+    class DijkstraRouter final : public IRouter<Weight> {
+    private:
+        using Graph = CsrGraph<Weight>;
+
+    public:
+        using RouteInfo = typename IRouter<Weight>::RouteInfo;
+        using SearchStats = typename IRouter<Weight>::SearchStats;
+
+        explicit DijkstraRouter(const Graph& graph);
+        // the memoized trees of the other router are shared: they are never changed, only replaced
+        DijkstraRouter(const Graph& graph, const DijkstraRouter& other);
+
+        std::unique_ptr<IRouter<Weight>> Clone(const Graph& graph) const override;
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+        std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& targets) const override;
+        std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+
+        SearchStats GetSearchStats() const override;
+
+        bool UpdateEdges(const std::vector<EdgeId>& increased_edges, const std::vector<EdgeId>& decreased_edges) override;
+
+    private:
+        struct RouteInternalData {
+            Weight weight;
+            std::optional<EdgeId> prev_edge;
+        };
+        using ShortestPathTree = std::vector<std::optional<RouteInternalData>>;
+
+        std::shared_ptr<const ShortestPathTree> GetShortestPathTree(VertexId from) const;
+        ShortestPathTree BuildShortestPathTree(VertexId from) const;
+        std::optional<RouteInfo> ExtractRoute(const ShortestPathTree& tree, VertexId to) const;
+
+        static constexpr Weight ZERO_WEIGHT{};
+        const Graph& graph_;
+
+        mutable std::mutex trees_mutex_;
+        mutable std::unordered_map<VertexId, std::shared_ptr<const ShortestPathTree>> trees_;
+
+        mutable std::atomic<size_t> searches_count_{ 0 };
+        mutable std::atomic<size_t> settled_vertices_count_{ 0 };
+    };
+
+    template <typename Weight>
+    DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+        : graph_(graph)
+    {
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    template <typename Weight>
+    DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph, const DijkstraRouter& other)
+        : graph_(graph)
+    {
+        std::lock_guard lock{ other.trees_mutex_ };
+        trees_ = other.trees_;
+    }
+
+    template <typename Weight>
+    std::unique_ptr<IRouter<Weight>> DijkstraRouter<Weight>::Clone(const Graph& graph) const {
+        return std::make_unique<DijkstraRouter>(graph, *this);
+    }
+
+    template <typename Weight>
+    std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        return ExtractRoute(*GetShortestPathTree(from), to);
+    }
+
+    template <typename Weight>
+    std::vector<std::optional<typename DijkstraRouter<Weight>::RouteInfo>> DijkstraRouter<Weight>::BuildRoutes(
+        VertexId from, const std::vector<VertexId>& targets) const {
+        const std::shared_ptr<const ShortestPathTree> tree = GetShortestPathTree(from);
+        std::vector<std::optional<RouteInfo>> routes;
+        routes.reserve(targets.size());
+        for (const VertexId to : targets) {
+            routes.push_back(ExtractRoute(*tree, to));
+        }
+        return routes;
+    }
+
+    template <typename Weight>
+    std::vector<std::optional<Weight>> DijkstraRouter<Weight>::BuildWeights(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        const std::shared_ptr<const ShortestPathTree> tree = GetShortestPathTree(from);
+        std::vector<std::optional<Weight>> weights;
+        weights.reserve(targets.size());
+        for (const VertexId to : targets) {
+            const auto& route_internal_data = tree->at(to);
+            weights.push_back(route_internal_data ? std::optional<Weight>{ route_internal_data->weight } : std::nullopt);
+        }
+        return weights;
+    }
+
+    template <typename Weight>
+    std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::ExtractRoute(
+        const ShortestPathTree& tree, VertexId to) const {
+        const auto& route_internal_data = tree.at(to);
+        if (!route_internal_data) {
+            return std::nullopt;
+        }
+        const Weight weight = route_internal_data->weight;
+        std::vector<EdgeId> edges;
+        for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
+            edge_id;
+            edge_id = tree[graph_.GetEdge(*edge_id).from]->prev_edge)
+        {
+            edges.push_back(*edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        return RouteInfo{ weight, std::move(edges) };
+    }
+
+    template <typename Weight>
+    std::shared_ptr<const typename DijkstraRouter<Weight>::ShortestPathTree>
+        DijkstraRouter<Weight>::GetShortestPathTree(VertexId from) const {
+        {
+            std::lock_guard lock{ trees_mutex_ };
+            if (auto it = trees_.find(from); it != trees_.end()) {
+                return it->second;
+            }
+        }
+
+        // the tree is built outside of the lock, so queries from other sources are not blocked
+        auto tree = std::make_shared<const ShortestPathTree>(BuildShortestPathTree(from));
+
+        std::lock_guard lock{ trees_mutex_ };
+        return trees_.emplace(from, std::move(tree)).first->second;
+    }
+
+    template <typename Weight>
+    typename DijkstraRouter<Weight>::SearchStats DijkstraRouter<Weight>::GetSearchStats() const {
+        return SearchStats{
+            .searches_count = searches_count_.load(std::memory_order_relaxed)
+            , .settled_vertices_count = settled_vertices_count_.load(std::memory_order_relaxed)
+        };
+    }
+
+    template <typename Weight>
+    bool DijkstraRouter<Weight>::UpdateEdges(const std::vector<EdgeId>& increased_edges
+        , const std::vector<EdgeId>& decreased_edges) {
+        //the same check as in the constructor, the engine made again throws
+        for (const EdgeId edge_id : decreased_edges) {
+            if (graph_.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+                return false;
+            }
+        }
+
+        const std::unordered_set<EdgeId> increased_edges_set{ increased_edges.begin(), increased_edges.end() };
+
+        //a tree is changed by a heavier edge it's made of or by a lighter edge shortening the way to its end
+        auto is_tree_changed = [this, &increased_edges_set, &decreased_edges](const ShortestPathTree& tree) {
+            for (const auto& route_internal_data : tree) {
+                if (route_internal_data && route_internal_data->prev_edge
+                    && increased_edges_set.contains(*route_internal_data->prev_edge)) {
+                    return true;
+                }
+            }
+            for (const EdgeId edge_id : decreased_edges) {
+                const Edge<Weight>& edge = graph_.GetEdge(edge_id);
+                if (edge.from >= tree.size() || !tree[edge.from]) {
+                    continue;
+                }
+                const Weight candidate_weight = tree[edge.from]->weight + edge.weight;
+                if (edge.to >= tree.size() || !tree[edge.to] || candidate_weight < tree[edge.to]->weight) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        std::lock_guard lock{ trees_mutex_ };
+        for (auto it = trees_.begin(); it != trees_.end();) {
+            if (is_tree_changed(*it->second)) {
+                it = trees_.erase(it);
+                continue;
+            }
+            //the new vertices can't be reached from a tree that isn't changed
+            if (it->second->size() < graph_.GetVertexCount()) {
+                auto tree = std::make_shared<ShortestPathTree>(*it->second);
+                tree->resize(graph_.GetVertexCount());
+                it->second = std::move(tree);
+            }
+            ++it;
+        }
+
+        return true;
+    }
+
+    template <typename Weight>
+    typename DijkstraRouter<Weight>::ShortestPathTree DijkstraRouter<Weight>::BuildShortestPathTree(
+        VertexId from) const {
+        using QueueItem = std::pair<Weight, VertexId>;
+
+        if (from >= graph_.GetVertexCount()) {
+            throw std::out_of_range("DijkstraRouter::BuildRoute: No such vertex");
+        }
+
+        ShortestPathTree tree(graph_.GetVertexCount());
+        std::vector<bool> settled(graph_.GetVertexCount(), false);
+        size_t settled_vertices = 0;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+        tree[from] = RouteInternalData{ ZERO_WEIGHT, std::nullopt };
+        queue.push({ ZERO_WEIGHT, from });
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (settled[vertex]) {
+                continue;
+            }
+            settled[vertex] = true;
+            ++settled_vertices;
+
+            const Weight vertex_weight = tree[vertex]->weight;
+            for (const auto& arc : graph_.GetArcs(vertex)) {
+                const Weight candidate_weight = vertex_weight + arc.weight;
+                auto& route_internal_data = tree[arc.to];
+                if (!route_internal_data || candidate_weight < route_internal_data->weight) {
+                    route_internal_data = RouteInternalData{ candidate_weight, arc.edge_id };
+                    queue.push({ candidate_weight, arc.to });
+                }
+            }
+        }
+
+        searches_count_.fetch_add(1, std::memory_order_relaxed);
+        settled_vertices_count_.fetch_add(settled_vertices, std::memory_order_relaxed);
+        return tree;
+    }
+
+}  // namespace graph
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace graph {
+
+    // Min-plus update of a routes table row through a vertex:
+    //     candidate = weight_from + weights_through[i]
+    //     if candidate < weights_relaxing[i]: weights_relaxing[i] = candidate and
+    //         prev_edges_relaxing[i] = prev_edges_through[i], or prev_edge_from if the former is no_edge
+    // Absent routes have to be +infinity. The weights and the previous edges are updated together
+    // by an AVX2 or SSE4.1 kernel chosen once at run time from the CPU features, or by the scalar loop
+    void RelaxRoutesRowMinPlus(size_t count, float weight_from, uint32_t prev_edge_from, uint32_t no_edge
+        , const float* weights_through, const uint32_t* prev_edges_through
+        , float* weights_relaxing, uint32_t* prev_edges_relaxing);
+
+    enum class MinPlusKernel {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+
+    MinPlusKernel GetMinPlusKernel();
+
+}  // namespace graph
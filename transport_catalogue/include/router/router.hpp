@@ -1,117 +1,552 @@
-#pragma once
-
-#include "graph.hpp"
-
-#include <algorithm>
-#include <cassert>
-#include <cstdint>
-#include <iterator>
-#include <optional>
-#include <stdexcept>
-#include <unordered_map>
-#include <utility>
-#include <vector>
-
-namespace graph {
-
-    template <typename Weight>
-    class Router {
-    private:
-        using Graph = DirectedWeightedGraph<Weight>;
-
-    public:
-        explicit Router(const Graph& graph);
-
-        struct RouteInfo {
-            Weight weight;
-            std::vector<EdgeId> edges;
-        };
-
-        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
-
-    private:
-        struct RouteInternalData {
-            Weight weight;
-            std::optional<EdgeId> prev_edge;
-        };
-        using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
-
-        void InitializeRoutesInternalData(const Graph& graph) {
-            const size_t vertex_count = graph.GetVertexCount();
-            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-                routes_internal_data_[vertex][vertex] = RouteInternalData{ ZERO_WEIGHT, std::nullopt };
-                for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
-                    const auto& edge = graph.GetEdge(edge_id);
-                    if (edge.weight < ZERO_WEIGHT) {
-                        throw std::domain_error("Edges' weights should be non-negative");
-                    }
-                    auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                    if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                        route_internal_data = RouteInternalData{ edge.weight, edge_id };
-                    }
-                }
-            }
-        }
-
-        void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-            const RouteInternalData& route_to) {
-            auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-            const Weight candidate_weight = route_from.weight + route_to.weight;
-            if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-                route_relaxing = { candidate_weight,
-                                  route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge };
-            }
-        }
-
-        void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-            for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-                if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                    for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                        if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                            RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-                        }
-                    }
-                }
-            }
-        }
-
-        static constexpr Weight ZERO_WEIGHT{};
-        const Graph& graph_;
-        RoutesInternalData routes_internal_data_;
-    };
-
-    template <typename Weight>
-    Router<Weight>::Router(const Graph& graph)
-        : graph_(graph)
-        , routes_internal_data_(graph.GetVertexCount(),
-            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
-    {
-        InitializeRoutesInternalData(graph);
-
-        const size_t vertex_count = graph.GetVertexCount();
-        for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-            RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
-        }
-    }
-
-    template <typename Weight>
-    std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-        VertexId to) const {
-        const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-        if (!route_internal_data) {
-            return std::nullopt;
-        }
-        const Weight weight = route_internal_data->weight;
-        std::vector<EdgeId> edges;
-        for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-            edge_id;
-            edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
-        {
-            edges.push_back(*edge_id);
-        }
-        std::reverse(edges.begin(), edges.end());
-
-        return RouteInfo{ weight, std::move(edges) };
-    }
-
+#pragma once
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "min_plus_kernel.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    template <typename Weight>
+    class IRouter {
+    public:
+        struct RouteInfo {
+            Weight weight;
+            std::vector<EdgeId> edges;
+        };
+
+        // counters of the graph searches run by an engine while answering queries
+        struct SearchStats {
+            size_t searches_count = 0;
+            size_t settled_vertices_count = 0;
+        };
+
+        virtual ~IRouter() = default;
+
+        // a copy of the engine for a copy of its graph, so the two are patched apart
+        // and the copy doesn't repeat the work done by this one
+        virtual std::unique_ptr<IRouter> Clone(const CsrGraph<Weight>& graph) const = 0;
+
+        virtual std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const = 0;
+
+        // routes from one source to each of the targets, in the order of the targets.
+        // Engines searching from a single source answer all of them with one search
+        virtual std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& targets) const {
+            std::vector<std::optional<RouteInfo>> routes;
+            routes.reserve(targets.size());
+            for (const VertexId to : targets) {
+                routes.push_back(BuildRoute(from, to));
+            }
+            return routes;
+        }
+
+        // only the weights of the same routes, engines able to skip the edges of the routes do
+        virtual std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const {
+            std::vector<std::optional<Weight>> weights;
+            weights.reserve(targets.size());
+            for (const std::optional<RouteInfo>& route : BuildRoutes(from, targets)) {
+                weights.push_back(route ? std::optional<Weight>{ route->weight } : std::nullopt);
+            }
+            return weights;
+        }
+
+        virtual SearchStats GetSearchStats() const {
+            return {};
+        }
+
+        // the graph was patched in place: increased_edges got heavier or lost their arcs,
+        // decreased_edges got lighter or were added, the vertex count could grow.
+        // Returns false if the engine can't patch its data and has to be created again,
+        // which is the default: e.g. the shortcuts of Contraction Hierarchies rest on witness
+        // searches that a heavier edge makes wrong, so the hierarchy is contracted anew
+        virtual bool UpdateEdges([[maybe_unused]] const std::vector<EdgeId>& increased_edges
+            , [[maybe_unused]] const std::vector<EdgeId>& decreased_edges) {
+            return false;
+        }
+    };
+
+    // All-pairs engine: the whole routes table is computed with Floyd-Warshall in the constructor.
+    // The table is a flat row-major matrix of packed cells: the route weight (single precision
+    // for double graphs) and the 32-bit id of the last edge of the route, absent values are sentinels.
+    // The relaxation is blocked: each round finishes the diagonal tile first, then the tiles
+    // of its row and column, then all the rest, the last two phases run on a thread pool.
+    // A table computed earlier for the same graph can be adopted instead, e.g. from a mapped file
+    template <typename Weight>
+    class Router final : public IRouter<Weight> {
+    private:
+        using Graph = CsrGraph<Weight>;
+
+    public:
+        using RouteInfo = typename IRouter<Weight>::RouteInfo;
+        using PackedWeight = std::conditional_t<std::is_same_v<Weight, double>, float, Weight>;
+        using PackedEdgeId = uint32_t;
+
+        // both arrays are row-major matrices of vertex_count * vertex_count cells
+        struct RoutesTable {
+            std::span<const PackedWeight> weights;
+            std::span<const PackedEdgeId> prev_edges;
+        };
+
+        explicit Router(const Graph& graph, size_t threads_count = 1);
+        // the table isn't copied, its memory has to outlive the router
+        Router(const Graph& graph, RoutesTable routes_table);
+        // a copy of the table of the other router for a copy of its graph, so the two are patched apart
+        Router(const Graph& graph, const Router& other);
+
+        std::unique_ptr<IRouter<Weight>> Clone(const Graph& graph) const override;
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+        std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+
+        RoutesTable GetRoutesTable() const;
+        // checks a table of an untrusted source, e.g. a file: the weights are sentinels or finite
+        // non-negative values and every route leads back along the graph edges to its source,
+        // so BuildRoute can neither leave the arrays nor loop. O(V^2)
+        static bool IsValidRoutesTable(const Graph& graph, RoutesTable routes_table);
+
+        // the rows of the sources whose routes go through a heavier or a removed edge (u, v),
+        // i.e. whose route to v ends with it, are computed again with Dijkstra's algorithm.
+        // Then a lighter or a new edge is relaxed into every route as the path to u, the edge
+        // and the path from v, which is O(V^2) per edge. New vertices, negative weights and
+        // more than a 1/MAX_RECOMPUTED_ROWS_PART of the rows to recompute need a new table
+        bool UpdateEdges(const std::vector<EdgeId>& increased_edges, const std::vector<EdgeId>& decreased_edges) override;
+
+    private:
+
+        static constexpr PackedWeight NO_ROUTE = std::numeric_limits<PackedWeight>::has_infinity
+            ? std::numeric_limits<PackedWeight>::infinity()
+            : std::numeric_limits<PackedWeight>::max();
+        static constexpr PackedEdgeId NO_EDGE = std::numeric_limits<PackedEdgeId>::max();
+
+        // weights and previous edges are kept in separate arrays, so the relaxation
+        // walks two contiguous rows instead of an array of structures
+        class RoutesInternalData {
+        public:
+            RoutesInternalData() = default;
+            explicit RoutesInternalData(size_t vertex_count)
+                : vertex_count_(vertex_count)
+                , weights_(vertex_count * vertex_count, NO_ROUTE)
+                , prev_edges_(vertex_count * vertex_count, NO_EDGE)
+                , table_{ weights_, prev_edges_ } {
+            }
+            RoutesInternalData(size_t vertex_count, RoutesTable table)
+                : vertex_count_(vertex_count)
+                , table_(table) {
+                if (table.weights.size() != vertex_count * vertex_count
+                    || table.prev_edges.size() != vertex_count * vertex_count) {
+                    throw std::length_error("The routes table doesn't match the graph");
+                }
+            }
+
+            // the mutable rows are only available for an owned table
+            PackedWeight* GetWeightsRow(VertexId vertex) {
+                return weights_.data() + vertex * vertex_count_;
+            }
+            const PackedWeight* GetWeightsRow(VertexId vertex) const {
+                return table_.weights.data() + vertex * vertex_count_;
+            }
+            PackedEdgeId* GetPrevEdgesRow(VertexId vertex) {
+                return prev_edges_.data() + vertex * vertex_count_;
+            }
+            const PackedEdgeId* GetPrevEdgesRow(VertexId vertex) const {
+                return table_.prev_edges.data() + vertex * vertex_count_;
+            }
+
+            RoutesTable GetTable() const {
+                return table_;
+            }
+
+            size_t GetVertexCount() const {
+                return vertex_count_;
+            }
+
+            // copies an adopted table, so it can be changed
+            void MakeOwned() {
+                if (weights_.data() == table_.weights.data()) {
+                    return;
+                }
+                weights_.assign(table_.weights.begin(), table_.weights.end());
+                prev_edges_.assign(table_.prev_edges.begin(), table_.prev_edges.end());
+                table_ = RoutesTable{ weights_, prev_edges_ };
+            }
+
+        private:
+            size_t vertex_count_ = 0;
+            std::vector<PackedWeight> weights_;
+            std::vector<PackedEdgeId> prev_edges_;
+            RoutesTable table_;
+        };
+
+        void InitializeRoutesInternalData(const Graph& graph) {
+            if (graph.GetEdgeCount() >= NO_EDGE) {
+                throw std::length_error("Too many edges for the routes table");
+            }
+
+            const size_t vertex_count = graph.GetVertexCount();
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                PackedWeight* weights = routes_internal_data_.GetWeightsRow(vertex);
+                PackedEdgeId* prev_edges = routes_internal_data_.GetPrevEdgesRow(vertex);
+                weights[vertex] = static_cast<PackedWeight>(ZERO_WEIGHT);
+                prev_edges[vertex] = NO_EDGE;
+                for (const auto& arc : graph.GetArcs(vertex)) {
+                    if (arc.weight < ZERO_WEIGHT) {
+                        throw std::domain_error("Edges' weights should be non-negative");
+                    }
+                    const PackedWeight arc_weight = static_cast<PackedWeight>(arc.weight);
+                    if (weights[arc.to] == NO_ROUTE || weights[arc.to] > arc_weight) {
+                        weights[arc.to] = arc_weight;
+                        prev_edges[arc.to] = static_cast<PackedEdgeId>(arc.edge_id);
+                    }
+                }
+            }
+        }
+
+        static void RelaxRoutesRow(size_t vertex_count, PackedWeight weight_from, PackedEdgeId prev_edge_from
+            , const PackedWeight* weights_through, const PackedEdgeId* prev_edges_through
+            , PackedWeight* weights_relaxing, PackedEdgeId* prev_edges_relaxing) {
+            if constexpr (std::is_same_v<PackedWeight, float>) {
+                RelaxRoutesRowMinPlus(vertex_count, weight_from, prev_edge_from, NO_EDGE
+                    , weights_through, prev_edges_through, weights_relaxing, prev_edges_relaxing);
+            }
+            else {
+                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                    if (weights_through[vertex_to] == NO_ROUTE) {
+                        continue;
+                    }
+                    const PackedWeight candidate_weight = weight_from + weights_through[vertex_to];
+                    if (weights_relaxing[vertex_to] == NO_ROUTE || candidate_weight < weights_relaxing[vertex_to]) {
+                        weights_relaxing[vertex_to] = candidate_weight;
+                        prev_edges_relaxing[vertex_to] = prev_edges_through[vertex_to] != NO_EDGE
+                            ? prev_edges_through[vertex_to]
+                            : prev_edge_from;
+                    }
+                }
+            }
+        }
+
+        // relaxes the routes of the "block_from" tile rows and the "block_to" tile columns
+        // through the vertices of the "block_through" tile
+        void RelaxRoutesInternalDataBlock(size_t vertex_count, size_t block_from, size_t block_to
+            , size_t block_through) {
+            const VertexId from_begin = block_from * BLOCK_SIZE;
+            const VertexId from_end = std::min(from_begin + BLOCK_SIZE, vertex_count);
+            const VertexId to_begin = block_to * BLOCK_SIZE;
+            const size_t to_count = std::min(to_begin + BLOCK_SIZE, vertex_count) - to_begin;
+            const VertexId through_begin = block_through * BLOCK_SIZE;
+            const VertexId through_end = std::min(through_begin + BLOCK_SIZE, vertex_count);
+
+            for (VertexId vertex_through = through_begin; vertex_through < through_end; ++vertex_through) {
+                const PackedWeight* weights_through = routes_internal_data_.GetWeightsRow(vertex_through) + to_begin;
+                const PackedEdgeId* prev_edges_through = routes_internal_data_.GetPrevEdgesRow(vertex_through) + to_begin;
+                for (VertexId vertex_from = from_begin; vertex_from < from_end; ++vertex_from) {
+                    PackedWeight* weights_from = routes_internal_data_.GetWeightsRow(vertex_from);
+                    PackedEdgeId* prev_edges_from = routes_internal_data_.GetPrevEdgesRow(vertex_from);
+                    if (weights_from[vertex_through] != NO_ROUTE) {
+                        RelaxRoutesRow(to_count, weights_from[vertex_through], prev_edges_from[vertex_through]
+                            , weights_through, prev_edges_through, weights_from + to_begin, prev_edges_from + to_begin);
+                    }
+                }
+            }
+        }
+
+        // the row of a source from a single-source search, O(E log V)
+        void ComputeRoutesRow(VertexId vertex_from) {
+            using QueueItem = std::pair<Weight, VertexId>;
+
+            const size_t vertex_count = graph_.GetVertexCount();
+            PackedWeight* weights = routes_internal_data_.GetWeightsRow(vertex_from);
+            PackedEdgeId* prev_edges = routes_internal_data_.GetPrevEdgesRow(vertex_from);
+            std::fill(weights, weights + vertex_count, NO_ROUTE);
+            std::fill(prev_edges, prev_edges + vertex_count, NO_EDGE);
+
+            std::vector<std::optional<Weight>> route_weights(vertex_count);
+            std::vector<bool> settled(vertex_count, false);
+            std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+            route_weights[vertex_from] = ZERO_WEIGHT;
+            queue.push({ ZERO_WEIGHT, vertex_from });
+            while (!queue.empty()) {
+                const VertexId vertex = queue.top().second;
+                queue.pop();
+                if (settled[vertex]) {
+                    continue;
+                }
+                settled[vertex] = true;
+                weights[vertex] = static_cast<PackedWeight>(*route_weights[vertex]);
+
+                for (const auto& arc : graph_.GetArcs(vertex)) {
+                    const Weight candidate_weight = *route_weights[vertex] + arc.weight;
+                    if (!route_weights[arc.to] || candidate_weight < *route_weights[arc.to]) {
+                        route_weights[arc.to] = candidate_weight;
+                        prev_edges[arc.to] = static_cast<PackedEdgeId>(arc.edge_id);
+                        queue.push({ candidate_weight, arc.to });
+                    }
+                }
+            }
+        }
+
+        void RelaxRoutesInternalData(size_t vertex_count, size_t threads_count) {
+            thread_pool::ThreadPool pool{ threads_count };
+            const size_t blocks_count = (vertex_count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            for (size_t block_through = 0; block_through < blocks_count; ++block_through) {
+                RelaxRoutesInternalDataBlock(vertex_count, block_through, block_through, block_through);
+
+                pool.ParallelFor(2 * blocks_count, [&](size_t index) {
+                    const size_t block = index / 2;
+                    if (block == block_through) {
+                        return;
+                    }
+                    if (index % 2 == 0) {
+                        RelaxRoutesInternalDataBlock(vertex_count, block_through, block, block_through);
+                    }
+                    else {
+                        RelaxRoutesInternalDataBlock(vertex_count, block, block_through, block_through);
+                    }
+                });
+
+                pool.ParallelFor(blocks_count, [&](size_t block_from) {
+                    if (block_from == block_through) {
+                        return;
+                    }
+                    for (size_t block_to = 0; block_to < blocks_count; ++block_to) {
+                        if (block_to != block_through) {
+                            RelaxRoutesInternalDataBlock(vertex_count, block_from, block_to, block_through);
+                        }
+                    }
+                });
+            }
+        }
+
+        static constexpr size_t BLOCK_SIZE = 64;
+        // a search per row is cheaper than the blocked relaxation of the whole table
+        // while it's run for at most this part of the rows
+        static constexpr size_t MAX_RECOMPUTED_ROWS_PART = 4;
+        static constexpr Weight ZERO_WEIGHT{};
+        const Graph& graph_;
+        RoutesInternalData routes_internal_data_;
+    };
+
+    template <typename Weight>
+    Router<Weight>::Router(const Graph& graph, size_t threads_count)
+        : graph_(graph)
+        , routes_internal_data_(graph.GetVertexCount())
+    {
+        InitializeRoutesInternalData(graph);
+        RelaxRoutesInternalData(graph.GetVertexCount(), threads_count);
+    }
+
+    template <typename Weight>
+    Router<Weight>::Router(const Graph& graph, RoutesTable routes_table)
+        : graph_(graph)
+        , routes_internal_data_(graph.GetVertexCount(), routes_table)
+    {
+    }
+
+    template <typename Weight>
+    Router<Weight>::Router(const Graph& graph, const Router& other)
+        : graph_(graph)
+        , routes_internal_data_(graph.GetVertexCount(), other.GetRoutesTable())
+    {
+        routes_internal_data_.MakeOwned();
+    }
+
+    template <typename Weight>
+    std::unique_ptr<IRouter<Weight>> Router<Weight>::Clone(const Graph& graph) const {
+        return std::make_unique<Router>(graph, *this);
+    }
+
+    template <typename Weight>
+    typename Router<Weight>::RoutesTable Router<Weight>::GetRoutesTable() const {
+        return routes_internal_data_.GetTable();
+    }
+
+    template <typename Weight>
+    bool Router<Weight>::IsValidRoutesTable(const Graph& graph, RoutesTable routes_table) {
+        const size_t vertex_count = graph.GetVertexCount();
+        if (routes_table.weights.size() != vertex_count * vertex_count
+            || routes_table.prev_edges.size() != vertex_count * vertex_count) {
+            return false;
+        }
+
+        // the routes of a row form a tree: a vertex is known to lead to the source once its walk reached it
+        enum class WalkState : uint8_t { Unknown, Walking, LeadsToSource };
+        std::vector<WalkState> states(vertex_count);
+        std::vector<VertexId> walk;
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            const PackedWeight* weights = routes_table.weights.data() + vertex_from * vertex_count;
+            const PackedEdgeId* prev_edges = routes_table.prev_edges.data() + vertex_from * vertex_count;
+            for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                const PackedWeight weight = weights[vertex_to];
+                const PackedEdgeId edge_id = prev_edges[vertex_to];
+                if (weight == NO_ROUTE) {
+                    if (edge_id != NO_EDGE) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (!(weight >= static_cast<PackedWeight>(ZERO_WEIGHT) && weight < NO_ROUTE)
+                    || (edge_id == NO_EDGE) != (vertex_to == vertex_from)
+                    || (edge_id != NO_EDGE && (edge_id >= graph.GetEdgeCount() || graph.GetEdge(edge_id).to != vertex_to))) {
+                    return false;
+                }
+            }
+
+            std::fill(states.begin(), states.end(), WalkState::Unknown);
+            states[vertex_from] = WalkState::LeadsToSource;
+            for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                if (weights[vertex_to] == NO_ROUTE) {
+                    continue;
+                }
+                VertexId vertex = vertex_to;
+                while (states[vertex] == WalkState::Unknown) {
+                    states[vertex] = WalkState::Walking;
+                    walk.push_back(vertex);
+                    vertex = graph.GetEdge(prev_edges[vertex]).from;
+                    if (weights[vertex] == NO_ROUTE) {
+                        return false;
+                    }
+                }
+                if (states[vertex] == WalkState::Walking) {
+                    return false;
+                }
+                for (const VertexId walked_vertex : walk) {
+                    states[walked_vertex] = WalkState::LeadsToSource;
+                }
+                walk.clear();
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Weight>
+    bool Router<Weight>::UpdateEdges(const std::vector<EdgeId>& increased_edges, const std::vector<EdgeId>& decreased_edges) {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (vertex_count != routes_internal_data_.GetVertexCount() || graph_.GetEdgeCount() >= NO_EDGE) {
+            return false;
+        }
+        for (const EdgeId edge_id : decreased_edges) {
+            if (graph_.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+                return false;
+            }
+        }
+
+        //the routes of a row form a tree, so a route going through the edge (u, v) is a route to v ending with it
+        std::vector<VertexId> recomputed_rows;
+        if (!increased_edges.empty()) {
+            std::vector<bool> is_recomputed(vertex_count, false);
+            for (const EdgeId edge_id : increased_edges) {
+                const VertexId vertex_to = graph_.GetEdge(edge_id).to;
+                for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+                    if (!is_recomputed[vertex_from]
+                        && std::as_const(routes_internal_data_).GetPrevEdgesRow(vertex_from)[vertex_to] == edge_id) {
+                        is_recomputed[vertex_from] = true;
+                        recomputed_rows.push_back(vertex_from);
+                    }
+                }
+            }
+            if (recomputed_rows.size() * MAX_RECOMPUTED_ROWS_PART > vertex_count) {
+                return false;
+            }
+        }
+
+        routes_internal_data_.MakeOwned();
+        //the recomputed rows already take in the lighter edges, the other rows are relaxed with them below
+        for (const VertexId vertex_from : recomputed_rows) {
+            ComputeRoutesRow(vertex_from);
+        }
+        for (const EdgeId edge_id : decreased_edges) {
+            const Edge<Weight>& edge = graph_.GetEdge(edge_id);
+            const PackedWeight edge_weight = static_cast<PackedWeight>(edge.weight);
+            const PackedWeight* weights_through = routes_internal_data_.GetWeightsRow(edge.to);
+            const PackedEdgeId* prev_edges_through = routes_internal_data_.GetPrevEdgesRow(edge.to);
+            for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+                PackedWeight* weights_from = routes_internal_data_.GetWeightsRow(vertex_from);
+                if (vertex_from == edge.to || weights_from[edge.from] == NO_ROUTE) {
+                    continue;
+                }
+                RelaxRoutesRow(vertex_count, weights_from[edge.from] + edge_weight, static_cast<PackedEdgeId>(edge_id)
+                    , weights_through, prev_edges_through, weights_from, routes_internal_data_.GetPrevEdgesRow(vertex_from));
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Weight>
+    std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        if (from >= graph_.GetVertexCount() || to >= graph_.GetVertexCount()) {
+            throw std::out_of_range("Router::BuildRoute: No such vertex");
+        }
+        if (routes_internal_data_.GetWeightsRow(from)[to] == NO_ROUTE) {
+            return std::nullopt;
+        }
+
+        const PackedEdgeId* prev_edges = routes_internal_data_.GetPrevEdgesRow(from);
+        std::vector<EdgeId> edges;
+        for (PackedEdgeId edge_id = prev_edges[to];
+            edge_id != NO_EDGE;
+            edge_id = prev_edges[graph_.GetEdge(edge_id).from])
+        {
+            edges.push_back(edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        //the packed weight is only precise enough to choose a route, the exact one is summed up again
+        Weight weight = ZERO_WEIGHT;
+        for (const EdgeId edge_id : edges) {
+            weight += graph_.GetEdge(edge_id).weight;
+        }
+
+        return RouteInfo{ weight, std::move(edges) };
+    }
+
+    template <typename Weight>
+    std::vector<std::optional<Weight>> Router<Weight>::BuildWeights(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        if (from >= graph_.GetVertexCount()) {
+            throw std::out_of_range("Router::BuildWeights: No such vertex");
+        }
+
+        const PackedWeight* weights_row = routes_internal_data_.GetWeightsRow(from);
+        const PackedEdgeId* prev_edges = routes_internal_data_.GetPrevEdgesRow(from);
+        std::vector<std::optional<Weight>> weights;
+        weights.reserve(targets.size());
+        for (const VertexId to : targets) {
+            if (to >= graph_.GetVertexCount()) {
+                throw std::out_of_range("Router::BuildWeights: No such vertex");
+            }
+            if (weights_row[to] == NO_ROUTE) {
+                weights.push_back(std::nullopt);
+                continue;
+            }
+            //the exact weight is summed up as in BuildRoute, only the edges aren't collected
+            Weight weight = ZERO_WEIGHT;
+            for (PackedEdgeId edge_id = prev_edges[to];
+                edge_id != NO_EDGE;
+                edge_id = prev_edges[graph_.GetEdge(edge_id).from])
+            {
+                weight += graph_.GetEdge(edge_id).weight;
+            }
+            weights.push_back(weight);
+        }
+        return weights;
+    }
+
 }  // namespace graph
\ No newline at end of file
@@ -1,78 +1,187 @@
-#pragma once
-
-#include "graph.hpp"
-#include "router.hpp"
-#include "domain.hpp"
-
-#include <vector>
-#include <unordered_map>
-#include <string_view>
-#include <memory>
-#include <optional>
-#include <variant>
-
-namespace transport_catalogue
-{
-	class TransportCatalogue;
-}//transport_catalogue
-
-namespace transport_router
-{
-	struct WaitItem {
-		std::string_view stop_name;
-		unsigned int time;
-	};
-
-	struct BusItem {
-		std::string_view bus;
-		unsigned int span_count;
-		double time;
-	};
-
-	struct Item {
-		std::variant<WaitItem, BusItem> content;
-	};
-
-	struct RouteInfo final {
-		double total_time;
-		std::vector<Item> items;
-	};
-
-	struct SizeTPairHasher {
-		auto operator() (const std::pair<size_t, size_t>& p) const -> size_t {
-			return std::hash<size_t>{}(p.first) * 47
-				+ std::hash<size_t>{}(p.second) * 47 * 47;
-		}
-	};
-
-	class TransportRouter final {
-	private:
-		using Catalogue = transport_catalogue::TransportCatalogue;
-		using Wrapper = ::transport_catalogue::size_t_wrapper::Wrapper;
-
-	public:
-		TransportRouter() = default;
-
-		struct TransportRouterInitList {
-			const unsigned int bus_wait_time;
-			const unsigned int bus_velocity;
-			const Catalogue* catalogue;
-		};
-
-		void Init(TransportRouterInitList&& init);
-		std::optional<const RouteInfo* const> GetRouteInfo(std::string_view from, std::string_view to);
-
-	private:
-		std::optional<const RouteInfo* const> CreateAndSaveNewRouteInfo(size_t from, size_t to);
-		void SetGraphWithRoutes();
-
-		unsigned int bus_wait_time_;
-		unsigned int bus_velocity_;
-		const Catalogue* catalogue_;
-		::graph::DirectedWeightedGraph<double> graph_;
-		std::unique_ptr<::graph::Router<double>> router_uptr_{ nullptr };
-		std::unique_ptr<Wrapper> wrapper_uptr_;
-
-		std::unordered_map<std::pair<size_t, size_t>, RouteInfo, SizeTPairHasher> routes_info_;
-	};
+#pragma once
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "router.hpp"
+#include "a_star_router.hpp"
+#include "contraction_hierarchies_router.hpp"
+#include "dijkstra_router.hpp"
+#include "domain.hpp"
+#include "lru_cache.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
+#include <memory>
+#include <optional>
+#include <variant>
+
+namespace transport_catalogue
+{
+	class TransportCatalogue;
+}//transport_catalogue
+
+namespace transport_router
+{
+	enum class RouterEngine {
+		FloydWarshall,	//all-pairs routes table computed at initialization
+		Dijkstra,		//shortest-path trees computed on demand and memoized per source
+		ContractionHierarchies,	//vertex hierarchy computed at initialization, bidirectional queries
+		AStar			//goal-directed search per query with the geographical lower bound
+	};
+
+	using GraphModel = ::transport_catalogue::size_t_wrapper::GraphModel;
+
+	struct WaitItem {
+		std::string_view stop_name;
+		unsigned int time;
+	};
+
+	struct BusItem {
+		std::string_view bus;
+		unsigned int span_count;
+		double time;
+	};
+
+	struct Item {
+		std::variant<WaitItem, BusItem> content;
+	};
+
+	struct RouteInfo final {
+		double total_time;
+		std::vector<Item> items;
+	};
+
+	//nullptr if there is no route
+	using RouteInfoPtr = std::shared_ptr<const RouteInfo>;
+
+	struct ReachableStop {
+		std::string_view stop_name;
+		double time;
+	};
+
+	struct TravelMatrix {
+		//a row for every source stop, nullopt if there is no route
+		std::vector<std::vector<std::optional<double>>> times;
+		//the routes in the same layout, empty unless they were asked for
+		std::vector<std::vector<RouteInfoPtr>> routes;
+	};
+
+	inline constexpr size_t DEFAULT_ROUTE_CACHE_BYTES{ 64 << 20 };
+	//a pool larger than that only switches between the threads
+	inline constexpr size_t MAX_THREADS_COUNT{ 1024 };
+
+	struct SizeTPairHasher {
+		auto operator() (const std::pair<size_t, size_t>& p) const -> size_t {
+			return std::hash<size_t>{}(p.first) * 47
+				+ std::hash<size_t>{}(p.second) * 47 * 47;
+		}
+	};
+
+	//stop names of the route start and end
+	using RouteRequest = std::pair<std::string_view, std::string_view>;
+
+	class TransportRouter final {
+	private:
+		using Catalogue = transport_catalogue::TransportCatalogue;
+		using Wrapper = ::transport_catalogue::size_t_wrapper::Wrapper;
+
+	public:
+		TransportRouter() = default;
+
+		struct TransportRouterInitList {
+			const unsigned int bus_wait_time;
+			const unsigned int bus_velocity;
+			const Catalogue* catalogue;
+			const RouterEngine engine{ RouterEngine::FloydWarshall };
+			const size_t threads_count{ 1 };
+			const GraphModel graph_model{ GraphModel::SubRoutes };
+			//the graph with the routes table or the contraction hierarchy is loaded from the file if it
+			//was saved for the same checksum, otherwise it's built and saved there. An empty name turns
+			//the cache off. The Dijkstra and A* engines have nothing to preprocess, only their graph is saved
+			const std::string cache_file{};
+			const uint64_t source_checksum{ 0 };
+			//the built routes are kept within the budget, the least recently used are evicted
+			const size_t route_cache_bytes{ DEFAULT_ROUTE_CACHE_BYTES };
+		};
+
+		void Init(TransportRouterInitList&& init);
+		//the router of the other one for a copy of its catalogue: the graph and the engine are copied
+		//, so the two are patched apart. The cached routes are carried over with the names of the copy
+		void InitCopy(const TransportRouter& other, const Catalogue* catalogue);
+		//the reads are safe to run concurrently: the routes cache synchronizes itself
+		RouteInfoPtr GetRouteInfo(std::string_view from, std::string_view to) const;
+		//answers in the order of the requests. The routes not built yet are grouped by the source stop
+		//, every source is searched once and the sources are searched in parallel
+		std::vector<RouteInfoPtr> GetRoutesInfo(const std::vector<RouteRequest>& requests) const;
+		//the stops reached from the stop within max_time with the same waits and rides as the routes
+		//, ordered by the time, empty for an unknown stop. One search stopped at the time bound
+		std::vector<ReachableStop> GetReachableStops(std::string_view from, double max_time) const;
+		//every source stop is searched once for all the targets and the sources are searched in parallel.
+		//The routes of the matrix bypass the routes cache
+		TravelMatrix GetTravelMatrix(const std::vector<std::string_view>& from
+			, const std::vector<std::string_view>& to, bool with_routes) const;
+		::graph::IRouter<double>::SearchStats GetSearchStats() const;
+		lru_cache::CacheStats GetRouteCacheStats() const;
+
+		//incremental updates after Init. Only the edges of the given routes are patched, the engine
+		//patches its data if it can and only the cached routes the change can affect are dropped
+		bool IsInitialized() const;
+		void UpdateRoutes(const std::vector<::transport_catalogue::details::RouteId>& routes);
+		void AddRoute(::transport_catalogue::details::RouteId route);
+		void RemoveRoute(::transport_catalogue::details::RouteId route);
+		//the routes don't depend on the stop locations, only the search heuristic of the A* engine does
+		void UpdateStopLocation(::transport_catalogue::details::StopId stop);
+
+	private:
+		//a built route with the edges it's made of, so an update finds the routes it changes.
+		//A missing route is cached as well, as a search finding nothing costs the most
+		struct CachedRoute {
+			std::optional<RouteInfo> info; //nullopt if there is no route
+			std::vector<::graph::EdgeId> edges;
+		};
+		using CachedRoutePtr = std::shared_ptr<const CachedRoute>;
+		using RoutesCache = lru_cache::ShardedLruCache<std::pair<size_t, size_t>, CachedRoute, SizeTPairHasher>;
+
+		//the vertex of the stop, nullopt for a stop without routes and for an unknown name
+		std::optional<size_t> WrapStop(std::string_view name) const;
+		RouteInfoPtr CreateAndSaveNewRouteInfo(size_t from, size_t to) const;
+		CachedRoutePtr CreateCachedRoute(std::optional<::graph::IRouter<double>::RouteInfo>&& raw_info) const;
+		RouteInfo CreateRouteInfo(const ::graph::IRouter<double>::RouteInfo& raw_info) const;
+		void SaveRouteInfo(size_t from, size_t to, const CachedRoutePtr& cached_route) const;
+		static RouteInfoPtr ShareRouteInfo(const CachedRoutePtr& cached_route);
+
+		Wrapper::Builder<Catalogue, Wrapper> CreateContinuedBuilder(::graph::DirectedWeightedGraph<double>& graph
+			, std::unique_ptr<Wrapper>&& wrapper, size_t vertex_count, size_t edge_count) const;
+		void ApplyEdgesUpdate(const std::vector<::graph::EdgeId>& increased_edges
+			, const std::vector<::graph::EdgeId>& decreased_edges);
+		void InvalidateCachedRoutes(const std::vector<::graph::EdgeId>& increased_edges
+			, const std::vector<::graph::EdgeId>& decreased_edges);
+		void SetGraphWithRoutes();
+		std::unique_ptr<::graph::IRouter<double>> CreateRouter() const;
+		::graph::AStarRouter<double>::Heuristic CreateGeoHeuristic() const;
+		bool LoadCache(const std::string& path, uint64_t source_checksum);
+		void SaveCache(const std::string& path, uint64_t source_checksum) const;
+
+		unsigned int bus_wait_time_;
+		unsigned int bus_velocity_;
+		RouterEngine engine_{ RouterEngine::FloydWarshall };
+		size_t threads_count_{ 1 };
+		GraphModel graph_model_{ GraphModel::SubRoutes };
+		size_t route_cache_bytes_{ DEFAULT_ROUTE_CACHE_BYTES };
+		const Catalogue* catalogue_;
+		::graph::DirectedWeightedGraph<double> graph_;
+		::graph::CsrGraph<double> csr_graph_;
+		std::optional<mapped_file::MappedFile> cache_mapping_; //keeps the loaded routes table, so it goes before the router
+		std::unique_ptr<::graph::IRouter<double>> router_uptr_{ nullptr };
+		std::unique_ptr<Wrapper> wrapper_uptr_;
+		std::unique_ptr<thread_pool::ThreadPool> pool_uptr_;
+
+		std::unique_ptr<RoutesCache> routes_cache_uptr_;
+	};
 } //transport_router
\ No newline at end of file
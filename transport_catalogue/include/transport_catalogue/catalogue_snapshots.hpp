@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "transport_catalogue.hpp"
+
+namespace transport_catalogue
+{
+	//The published catalogue: a finalized catalogue that is no longer changed, swapped for a new one as a whole.
+	//A reader pins the current snapshot for a request and keeps reading it after a newer one is published.
+	//The replaced snapshots are destroyed by the writer once their readers unpin them
+	//, so a reader never pays for the destruction of a catalogue
+	class CatalogueSnapshots {
+	public:
+		using Snapshot = std::shared_ptr<const TransportCatalogue>;
+
+		CatalogueSnapshots() = default;
+		explicit CatalogueSnapshots(Snapshot snapshot);
+
+		//the current snapshot, nullptr before the first one is published
+		Snapshot Pin() const;
+
+		//the snapshot has to be finalized, it replaces the current one for the readers pinning after it
+		void Publish(Snapshot snapshot);
+		//publishes a changed copy of the current snapshot, the readers keep the current one meanwhile.
+		//The copy is finalized after the change, so it's frozen and indexed before a reader sees it.
+		//The updates run one at a time, each one copies the snapshot published by the one before
+		void Update(const std::function<void(TransportCatalogue&)>& change);
+		//destroys the replaced snapshots no reader pins any more, returns how many are still pinned
+		size_t Reclaim();
+
+	private:
+		std::atomic<Snapshot> current_;
+		std::mutex update_mutex_;
+
+		std::mutex retired_mutex_;
+		std::vector<Snapshot> retired_;
+	};
+}//transport_catalogue
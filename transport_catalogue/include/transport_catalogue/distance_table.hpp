@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "domain.hpp"
+#include "mapped_array.hpp"
+
+namespace transport_catalogue
+{
+	//Road distances between stops in metres, frozen into a compressed sparse row array:
+	//the distances from every stop sorted by the neighbour id, so a lookup is a search in one short row.
+	//Only the given directions are kept, a missing one is taken from the opposite direction.
+	//The distances new to the frozen rows wait aside in a sorted map until the next Freeze,
+	//the lookups read both without changing the table, so they are safe to run concurrently
+	class DistanceTable {
+	public:
+		using StopId = details::StopId;
+		using Distance = uint32_t;
+
+		struct Arc {
+			StopId to;
+			Distance distance;
+		};
+
+		DistanceTable() = default;
+		//views the frozen arrays given out by GetOffsets and GetArcs
+		DistanceTable(std::span<const uint32_t> offsets, std::span<const Arc> arcs);
+
+		void Set(StopId from, StopId to, Distance distance);
+		//the distance from the stop to the other one or back, nullopt if neither is set
+		std::optional<Distance> Find(StopId from, StopId to) const;
+		size_t GetEntriesCount() const;
+
+		//merges the waiting distances into the rows. O(E) for any number of them
+		void Freeze();
+		bool IsFrozen() const;
+
+		//the frozen arrays: the arcs of the stop i are at [offsets[i], offsets[i + 1]).
+		//Throw unless the table is frozen
+		std::span<const uint32_t> GetOffsets() const;
+		std::span<const Arc> GetArcs() const;
+
+	private:
+		const Arc* FindArc(StopId from, StopId to) const;
+		std::optional<Distance> FindDirected(StopId from, StopId to) const;
+
+		mapped_file::MappedArray<uint32_t> offsets_{ std::vector<uint32_t>{ 0 } };
+		mapped_file::MappedArray<Arc> arcs_;
+		//ordered as the rows, so the freeze merges them in one pass
+		std::map<std::pair<StopId, StopId>, Distance> pending_entries_;
+	};
+}//transport_catalogue
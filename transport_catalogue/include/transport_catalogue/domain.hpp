@@ -1,206 +1,344 @@
-#pragma once
-#include <forward_list>
-#include <string_view>
-#include <unordered_set>
-#include <map>
-#include <unordered_map>
-#include <memory>
-#include <optional>
-
-#include "geo.hpp"
-#include "graph.hpp"
-
-namespace transport_catalogue
-{
-	namespace details
-	{
-		struct Stop {
-			Stop() = default;
-			Stop(const std::string_view&& name, const geo::Coordinates location);
-			std::string_view name;
-			geo::Coordinates location;
-		};
-
-		struct StopPtrPairHasher {
-			auto operator() (std::pair<const Stop* const, const Stop* const> pair_to_hash) const -> size_t {
-				return std::hash<std::string_view>{}(pair_to_hash.first->name) * 47
-					+ std::hash<std::string_view>{}(pair_to_hash.second->name) * 47 * 47;
-			}
-		};
-
-		struct Route {
-			Route() = default;
-			Route(std::string_view&& name, std::forward_list<Stop*>&& stops);
-			Route(const std::string_view& name, std::forward_list<Stop*>&& stops);
-			~Route() = default;
-
-			std::string_view name;
-			std::forward_list<Stop*> stops;
-		};
-
-		struct RoutePtrHasher {
-			auto operator() (Route* route) const -> size_t {
-				return std::hash<std::string_view>{}(route->name);
-			}
-		};
-
-		struct StopInfo {
-			std::string_view name;
-			std::unordered_set<Route*, RoutePtrHasher>* routes;
-		};
-
-		struct RouteInfo {
-			std::string_view name;
-			unsigned short stops_count;
-			unsigned short unique_stops_count;
-			size_t distance_total;
-			double curvature;
-		};
-	}//details
-
-	namespace size_t_wrapper
-	{
-		class Wrapper {
-		private:
-			using VertexT = details::Stop;
-			using CPtrVertexT = const VertexT* const;
-
-		public:
-			struct EdgeInfo {
-				std::string_view bus_name;
-				std::string_view wait_stop_name;
-				unsigned int span_count;
-				double time;
-			};
-
-			struct StopInfo {
-				std::string_view name;
-			};
-
-			template<typename Catalogue, typename Wrapper>
-			class Builder {
-			public:
-				struct BuilderInit {
-					const Catalogue& catalogue;
-					::graph::DirectedWeightedGraph<double>& graph;
-					unsigned int bus_wait_time;
-					unsigned int bus_velocity;
-				};
-
-				Builder(BuilderInit&& init)
-					: catalogue_{ init.catalogue }, graph_{ init.graph }
-					, bus_wait_time_{ init.bus_wait_time }, bus_velocity_{ init.bus_velocity }
-				{}
-
-				std::unique_ptr<Wrapper> Make() {
-					for (const auto& [name, route] : catalogue_.unique_routes_) {
-						CreateSubRoutes(name, route);
-					}
-
-					return std::make_unique<Wrapper>(wrapper_);
-				}
-
-			private:
-				void CreateSubRoutes(const std::string_view name, const details::Route& route)
-				{
-					using StopIt = std::forward_list<details::Stop*>::const_iterator;
-
-					std::forward_list<details::Stop*> route_reversed;
-					for (details::Stop* stop_ptr : route.stops) {
-						route_reversed.push_front(stop_ptr);
-					}
-
-					StopIt base_stop_it{ route_reversed.begin() };
-					StopIt prev_stop_it{ base_stop_it };
-					unsigned int span_count{ 0 };
-					unsigned long prev_distance{ 0 };
-					for (StopIt stop_it{ base_stop_it }; base_stop_it != route_reversed.end();) {
-						stop_it++;
-						span_count++;
-						if (stop_it == route_reversed.end() || *stop_it == *base_stop_it) {
-							base_stop_it++;
-							stop_it = base_stop_it;
-							prev_stop_it = base_stop_it;
-							span_count = 0;
-							prev_distance = 0;
-							continue;
-						}
-						
-						size_t base_stop_id = GiveStopId(*base_stop_it);
-						size_t stop_id = GiveStopId(*stop_it);
-
-						unsigned long new_step{ catalogue_.GetDistanceBetweenStops(*prev_stop_it, *stop_it) };
-						double weight{ (new_step + prev_distance)	// m
-							/ 1000.									// m -> km
-							/ static_cast<double>(bus_velocity_)	// km -> h (km \ km_per_h)
-							* 60.									// h -> min
-						};
-						graph_.AddEdge({
-							.from = base_stop_id,
-							.to = stop_id,
-							.weight = weight + static_cast<double>(bus_wait_time_)
-						});
-
-						wrapper_.AddEdge(edge_number_, std::move(EdgeInfo{
-								.bus_name = name,
-								.wait_stop_name = (*base_stop_it)->name,
-								.span_count = span_count,
-								.time = weight
-							})
-						);
-						edge_number_++;
-
-						prev_distance += new_step;
-						prev_stop_it++;
-					}
-				}
-
-				size_t GiveStopId(const details::Stop* const stop_ptr) {
-					if (wrapper_.vertex_to_id_map_.contains(stop_ptr)) {
-						return wrapper_.vertex_to_id_map_.at(stop_ptr);
-					}
-
-					wrapper_.vertex_to_id_map_.insert({ stop_ptr, vertex_number_ });
-					wrapper_.id_to_vertex_map_.insert({ vertex_number_, StopInfo{ .name = stop_ptr->name } });
-					vertex_number_++;
-					return vertex_number_ - 1;
-				}
-
-				const Catalogue& catalogue_;
-				::graph::DirectedWeightedGraph<double>& graph_;
-				const unsigned int bus_wait_time_;
-				const unsigned int bus_velocity_;
-				size_t vertex_number_{ 0 };
-				size_t edge_number_{ 0 };
-				Wrapper wrapper_{};
-			};
-
-			std::optional<size_t> WrapVertex(const VertexT* const ptr) const {
-				if (auto it = vertex_to_id_map_.find(ptr); it != vertex_to_id_map_.end()){
-					return it->second;
-				}
-
-				return std::nullopt;
-			}
-
-			const StopInfo& UnwrapVertex(const size_t id) const {
-				return id_to_vertex_map_.at(id);
-			}
-
-			const EdgeInfo& UnwrapEdge(const size_t edge_number) const {
-				return id_to_edge_map_.at(edge_number);
-			}
-
-		private:
-			Wrapper() = default;
-
-			void AddEdge(const size_t id, const EdgeInfo&& info) {
-				id_to_edge_map_.insert({id, std::move(info)});
-			}
-
-			std::map<CPtrVertexT, const size_t> vertex_to_id_map_;
-			std::map<const size_t, StopInfo> id_to_vertex_map_;
-			std::map<const size_t, const EdgeInfo> id_to_edge_map_;
-		};
-	}//size_t_wrapper
-}
\ No newline at end of file
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "geo.hpp"
+#include "graph.hpp"
+
+namespace transport_catalogue
+{
+	namespace details
+	{
+		//stops and routes are numbered in the order they are added, the ids index the catalogue arrays
+		using StopId = uint32_t;
+		using RouteId = uint32_t;
+
+		inline constexpr StopId NO_STOP{ std::numeric_limits<StopId>::max() };
+
+		struct StopInfo {
+			std::string_view name;
+			std::span<const RouteId> routes;	//sorted by the names in a finalized catalogue
+		};
+
+		struct RouteInfo {
+			std::string_view name;
+			uint32_t stops_count;
+			uint32_t unique_stops_count;
+			size_t distance_total;
+			double curvature;
+		};
+	}//details
+
+	namespace size_t_wrapper
+	{
+		enum class GraphModel {
+			SubRoutes,	//an edge for every pair of stops of a route, its weight includes the wait
+			Transfers	//a vertex for every stop of a route, edges to board, ride to the next stop and alight
+		};
+
+		class Wrapper {
+		private:
+			using StopId = details::StopId;
+			using RouteId = details::RouteId;
+
+		public:
+			enum class EdgeKind {
+				SubRoute,	//wait at the stop and ride the bus through span_count stops
+				Board,		//wait for the bus at the stop
+				Ride,		//ride the bus to the next stop
+				Alight		//get off the bus
+			};
+
+			struct EdgeInfo {
+				RouteId bus;
+				StopId wait_stop;
+				unsigned int span_count;
+				double time;
+				EdgeKind kind{ EdgeKind::SubRoute };
+			};
+
+			template<typename Catalogue, typename Wrapper>
+			class Builder {
+			public:
+				struct BuilderInit {
+					const Catalogue& catalogue;
+					::graph::DirectedWeightedGraph<double>& graph;
+					unsigned int bus_wait_time;
+					unsigned int bus_velocity;
+					GraphModel model{ GraphModel::SubRoutes };
+				};
+
+				Builder(BuilderInit&& init)
+					: catalogue_{ init.catalogue }, graph_{ init.graph }
+					, bus_wait_time_{ init.bus_wait_time }, bus_velocity_{ init.bus_velocity }
+					, model_{ init.model }
+				{}
+
+				//continues a built wrapper (an empty one for nullptr) with the routes added by AddRoute:
+				//the new vertices and edges take the ids after the given counts.
+				//The graph gets the new edges only, so it needs vertex_count + 2 * (stops of the routes) vertices
+				Builder(BuilderInit&& init, std::unique_ptr<Wrapper>&& wrapper, size_t vertex_count, size_t edge_count)
+					: Builder(std::move(init))
+				{
+					if (wrapper) {
+						wrapper_ = std::move(*wrapper);
+					}
+					vertex_number_ = vertex_count;
+					edge_number_ = edge_count;
+					is_continued_ = true;
+				}
+
+				std::unique_ptr<Wrapper> Make() {
+					if (model_ == GraphModel::Transfers) {
+						//stop vertices take the ids below the stops count, ride vertices follow them
+						size_t vertex_count{ catalogue_.GetStopsCount() };
+						for (RouteId route = 0; route < catalogue_.GetRoutesCount(); ++route) {
+							vertex_count += catalogue_.GetRouteStops(route).size();
+						}
+						graph_ = ::graph::DirectedWeightedGraph<double>{ vertex_count };
+						ride_vertex_number_ = catalogue_.GetStopsCount();
+					}
+
+					for (RouteId route = 0; route < catalogue_.GetRoutesCount(); ++route) {
+						AddRoute(route);
+					}
+
+					return std::make_unique<Wrapper>(wrapper_);
+				}
+
+				void AddRoute(const RouteId route) {
+					if (model_ == GraphModel::Transfers) {
+						CreateTransferRoute(route);
+					}
+					else {
+						CreateSubRoutes(route);
+					}
+				}
+
+				//the wrapper continued with the added routes
+				std::unique_ptr<Wrapper> Release() {
+					return std::make_unique<Wrapper>(std::move(wrapper_));
+				}
+
+				size_t GetVertexCount() const {
+					return std::max(vertex_number_, ride_vertex_number_);
+				}
+
+			private:
+				void CreateSubRoutes(const RouteId route)
+				{
+					const auto stops{ catalogue_.GetRouteStops(route) };
+					for (size_t base = 0; base < stops.size(); ++base) {
+						for (size_t next = base + 1; next < stops.size() && stops[next] != stops[base]; ++next) {
+							size_t base_stop_id = GiveStopId(stops[base]);
+							size_t stop_id = GiveStopId(stops[next]);
+
+							double weight{ ComputeRideTime(catalogue_.GetRouteDistance(route, base, next)) };
+							AddEdge(base_stop_id, stop_id, weight + static_cast<double>(bus_wait_time_), EdgeInfo{
+									.bus = route,
+									.wait_stop = stops[base],
+									.span_count = static_cast<unsigned int>(next - base),
+									.time = weight
+								}
+							);
+						}
+					}
+				}
+
+				void CreateTransferRoute(const RouteId route)
+				{
+					const auto stops{ catalogue_.GetRouteStops(route) };
+
+					//a continued builder has no range reserved for the ride vertices
+					size_t& next_vertex{ is_continued_ ? vertex_number_ : ride_vertex_number_ };
+					const size_t first_ride_vertex{ next_vertex };
+					next_vertex += stops.size();
+					for (size_t i = 0; i < stops.size(); ++i) {
+						const size_t stop_id = GiveStopId(stops[i]);
+						const size_t ride_vertex = first_ride_vertex + i;
+						wrapper_.SetVertexStop(ride_vertex, stops[i]);
+
+						if (i + 1 < stops.size()) {
+							AddEdge(stop_id, ride_vertex, static_cast<double>(bus_wait_time_), EdgeInfo{
+									.bus = route,
+									.wait_stop = stops[i],
+									.span_count = 0,
+									.time = 0.,
+									.kind = EdgeKind::Board
+								}
+							);
+
+							double weight{ ComputeRideTime(catalogue_.GetRouteDistance(route, i, i + 1)) };
+							AddEdge(ride_vertex, ride_vertex + 1, weight, EdgeInfo{
+									.bus = route,
+									.wait_stop = stops[i],
+									.span_count = 1,
+									.time = weight,
+									.kind = EdgeKind::Ride
+								}
+							);
+						}
+						if (i > 0) {
+							AddEdge(ride_vertex, stop_id, 0., EdgeInfo{
+									.bus = route,
+									.wait_stop = stops[i],
+									.span_count = 0,
+									.time = 0.,
+									.kind = EdgeKind::Alight
+								}
+							);
+						}
+					}
+				}
+
+				double ComputeRideTime(unsigned long distance) const {
+					return distance							// m
+						/ 1000.								// m -> km
+						/ static_cast<double>(bus_velocity_)	// km -> h (km \ km_per_h)
+						* 60.;								// h -> min
+				}
+
+				void AddEdge(size_t from, size_t to, double weight, EdgeInfo&& info) {
+					graph_.AddEdge({
+						.from = from,
+						.to = to,
+						.weight = weight
+					});
+					wrapper_.AddEdge(edge_number_, std::move(info));
+					edge_number_++;
+				}
+
+				size_t GiveStopId(const StopId stop) {
+					if (std::optional<size_t> vertex = wrapper_.WrapVertex(stop)) {
+						return vertex.value();
+					}
+
+					wrapper_.SetStopVertex(stop, vertex_number_);
+					vertex_number_++;
+					return vertex_number_ - 1;
+				}
+
+				const Catalogue& catalogue_;
+				::graph::DirectedWeightedGraph<double>& graph_;
+				const unsigned int bus_wait_time_;
+				const unsigned int bus_velocity_;
+				const GraphModel model_;
+				size_t vertex_number_{ 0 };
+				size_t ride_vertex_number_{ 0 };
+				size_t edge_number_{ 0 };
+				bool is_continued_{ false };
+				Wrapper wrapper_{};
+			};
+
+			//fills the wrapper with the vertices and edges saved from a built one
+			class Restorer {
+			public:
+				void AddStopVertex(const size_t id, const StopId stop) {
+					wrapper_->SetStopVertex(stop, id);
+				}
+
+				void AddRideVertex(const size_t id, const StopId stop) {
+					wrapper_->SetVertexStop(id, stop);
+				}
+
+				void AddEdge(const size_t id, EdgeInfo&& info) {
+					wrapper_->AddEdge(id, std::move(info));
+				}
+
+				std::unique_ptr<Wrapper> Make() {
+					return std::move(wrapper_);
+				}
+
+			private:
+				std::unique_ptr<Wrapper> wrapper_{ new Wrapper{} }; //the wrapper is incomplete here
+			};
+
+			std::optional<size_t> WrapVertex(const StopId stop) const {
+				if (stop < stop_to_vertex_.size() && stop_to_vertex_[stop] != NO_VERTEX) {
+					return stop_to_vertex_[stop];
+				}
+
+				return std::nullopt;
+			}
+
+			//the stop of a stop vertex or of a ride vertex, nullopt for an unknown vertex
+			std::optional<StopId> UnwrapVertex(const size_t id) const {
+				if (id < vertex_to_stop_.size() && vertex_to_stop_[id] != details::NO_STOP) {
+					return vertex_to_stop_[id];
+				}
+
+				return std::nullopt;
+			}
+
+			bool IsStopVertex(const size_t id) const {
+				const std::optional<StopId> stop{ UnwrapVertex(id) };
+				return stop && stop_to_vertex_[stop.value()] == id;
+			}
+
+			const EdgeInfo& UnwrapEdge(const size_t edge_number) const {
+				return edges_.at(edge_number);
+			}
+
+			//ids of the edges made for the route, in the order they were added
+			const std::vector<size_t>& GetRouteEdges(const RouteId route) const {
+				static const std::vector<size_t> no_edges;
+				return route < route_to_edges_.size() ? route_to_edges_[route] : no_edges;
+			}
+
+			//forgets the edges of the route, their ids stay taken
+			std::vector<size_t> RemoveRouteEdges(const RouteId route) {
+				if (route >= route_to_edges_.size()) {
+					return {};
+				}
+				return std::exchange(route_to_edges_[route], {});
+			}
+
+			void SetEdgeTime(const size_t edge_number, const double time) {
+				edges_.at(edge_number).time = time;
+			}
+
+		private:
+			static constexpr size_t NO_VERTEX{ std::numeric_limits<size_t>::max() };
+
+			Wrapper() = default;
+
+			void SetStopVertex(const StopId stop, const size_t id) {
+				if (stop >= stop_to_vertex_.size()) {
+					stop_to_vertex_.resize(stop + 1, NO_VERTEX);
+				}
+				stop_to_vertex_[stop] = id;
+				SetVertexStop(id, stop);
+			}
+
+			void SetVertexStop(const size_t id, const StopId stop) {
+				if (id >= vertex_to_stop_.size()) {
+					vertex_to_stop_.resize(id + 1, details::NO_STOP);
+				}
+				vertex_to_stop_[id] = stop;
+			}
+
+			void AddEdge(const size_t id, EdgeInfo&& info) {
+				if (info.bus >= route_to_edges_.size()) {
+					route_to_edges_.resize(info.bus + 1);
+				}
+				route_to_edges_[info.bus].push_back(id);
+				if (id >= edges_.size()) {
+					edges_.resize(id + 1);
+				}
+				edges_[id] = std::move(info);
+			}
+
+			std::vector<size_t> stop_to_vertex_;
+			std::vector<StopId> vertex_to_stop_;
+			std::vector<EdgeInfo> edges_;
+			std::vector<std::vector<size_t>> route_to_edges_;
+		};
+	}//size_t_wrapper
+}
@@ -1,269 +1,377 @@
-#pragma once
-
-#include <algorithm>
-#include "cassert"
-#include <forward_list>
-#include <iomanip>
-#include <iostream>
-#include <queue>
-#include <string>
-#include <sstream>
-#include <variant>
-#include <vector>
-
-#include "geo.hpp"
-#include "transport_catalogue.hpp"
-#include "map_renderer.hpp"
-#include "json_builder.hpp"
-
-namespace transport_catalogue
-{
-	namespace configurator
-	{
-		enum class QueryType {
-			StopCreate,
-			RouteCreate,
-			DistanceSet,
-			MapRender,
-			InitRouter
-		};
-
-		struct StringViewPairHasher {
-			auto operator() (std::pair<std::string_view, std::string_view> pair) const -> size_t {
-				return std::hash<std::string_view>{}(pair.first) * 47
-					+ std::hash<std::string_view>{}(pair.second) * 47 * 47;
-			}
-		};
-
-		struct StopCreateQueryContent {
-			std::string_view name;
-			geo::Coordinates location;
-		};
-
-		struct RouteCreateQueryContent {
-			std::string_view name;
-			std::vector<std::string_view> stops_names;
-			bool is_round_trip;
-		};
-
-		struct DistanceSetQueryContent {
-			std::unordered_map<
-				std::pair<std::string_view, std::string_view>
-				, unsigned long, StringViewPairHasher
-			> distances;
-		};
-
-		struct InitRouterQueryContent {
-			unsigned int bus_wait_time;
-			unsigned int bus_velocity;
-		};
-
-		struct Query {
-			QueryType type;
-			std::variant<StopCreateQueryContent
-						, RouteCreateQueryContent
-						, DistanceSetQueryContent
-						, svg_renderer::RenderSettings
-						, InitRouterQueryContent
-			> content;
-		};
-
-		class QueryPtrCompare {
-		public:
-			bool operator() (const Query* lhs, const Query* rhs) const {
-				//MapRender - highest priority
-				//StopCreate - high priority
-				//DistanceSet - middle priority
-				//RouteCreate - low priority
-				//InitRouter - lowest priority
-				if (lhs->type == rhs->type) {
-					return false;
-				}
-				if (lhs->type == QueryType::MapRender) {
-					return false;
-				}
-				if (rhs->type == QueryType::MapRender) {
-					return true;
-				}
-				if (lhs->type == QueryType::StopCreate) {
-					return false;
-				}
-				if (rhs->type == QueryType::StopCreate) {
-					return true;
-				}
-				if (lhs->type == QueryType::DistanceSet) {
-					return false;
-				}
-				if (rhs->type == QueryType::DistanceSet) {
-					return true;
-				}
-				if (rhs->type == QueryType::InitRouter) {
-					return false;
-				}
-				return true;
-			}
-		};
-
-		class IInputReader {
-		public:
-			virtual ~IInputReader() = default;
-
-		protected:
-			std::priority_queue<Query*, std::vector<Query*>, QueryPtrCompare>* query_ptr_queue_;
-			std::unordered_set<std::string> unique_strings;
-
-			std::deque<Query>* queries_;
-		};
-
-		class IDataBaseConfigurator {
-		public:
-			virtual ~IDataBaseConfigurator() = default;
-
-		protected:
-			void ExecuteQueries();
-			void ExecuteQuery(Query& query);
-
-			void FindRouteStops(
-				std::vector<std::string_view>& stops_names_ref
-				, svg_renderer::RouteData& route_data
-			);
-
-			TransportCatalogue* catalogue_;
-			std::priority_queue<Query*, std::vector<Query*>, QueryPtrCompare> query_ptr_queue_;
-			std::deque<Query> queries_;
-		};
-
-		namespace json_io
-		{
-			class InputReader : public IInputReader{
-			public:
-				InputReader(
-					std::priority_queue<Query*,std::vector<Query*>,QueryPtrCompare>* query_ref_queue
-					, std::deque<Query>* queries
-				);
-
-				size_t ReadQueries(const json::Node& node);
-				void ProcessMapRenderQuery(const json::Node& node);
-				void ProcessInitRouterQuery(const json::Node& node);
-
-			private:
-				void ProcessStopQuery(const json::Node& node);
-				void ProcessRouteQuery(const json::Node& node);
-
-				std::vector<std::string_view> MakeRouteCircle(std::vector<std::string_view>&& stops);
-
-				svg_renderer::Color ParseColorFromJSON(const json::Node& node);
-			};
-
-			class DataBaseConfigurator : public IDataBaseConfigurator {
-			public:
-				DataBaseConfigurator() = delete;
-				DataBaseConfigurator(TransportCatalogue* catalogue);
-				~DataBaseConfigurator() = default;
-
-				void SetCatalogue(const json::Node& node_ref);
-				void ReadMapRenderQuery(const json::Node& node);
-				void ReadInitRouterQuery(const json::Node& node);
-
-			private:
-				size_t GetQueries(const json::Node& node_ref);
-				InputReader input_reader_{ &query_ptr_queue_, &queries_ };
-			};
-		}
-	}//configurator
-
-	namespace io_handler
-	{
-		enum class QueryType {
-			RouteInfo,
-			StopInfo,
-			DrawMap,
-			BuildRoute
-		};
-
-		struct StopInfoQueryContent {
-			std::string name;
-		};
-
-		struct RouteInfoQueryContent {
-			std::string name;
-		};
-
-		struct BuildRouteQueryContent {
-			std::string from;
-			std::string to;
-		};
-
-		struct Query {
-			int id;
-			QueryType type;
-			std::variant<
-				StopInfoQueryContent
-				, RouteInfoQueryContent
-				, std::monostate
-				, BuildRouteQueryContent
-			> content;
-		};
-
-		class IInputReader {
-		public:
-			virtual ~IInputReader() = default;
-
-		protected:
-			std::queue<Query>* query_queue_;
-		};
-
-		class IDataBaseIOHandler {
-		public:
-			virtual ~IDataBaseIOHandler() = default;
-
-		protected:
-			void ExecuteQueries();
-			virtual void ExecuteQuery(Query& query) = 0;
-
-			TransportCatalogue* catalogue_;
-			std::queue<Query> query_queue_;
-		};
-
-		namespace json_io
-		{
-			class InputReader : public IInputReader{
-			public:
-				InputReader(std::queue<Query>* query_queue);
-
-				size_t ReadQueries(const json::Node& node);
-
-				void ProcessDrawMapQuery(const json::Node& node);
-
-			private:
-				void ProcessRouteGetInfoQuery(const json::Node& node);
-				void ProcessStopGetInfoQuery(const json::Node& node);
-				void ProcessBuildRouteQuery(const json::Node& node);
-			};
-
-			class DataBaseIOHandler : public IDataBaseIOHandler {
-			public:
-				DataBaseIOHandler() = delete;
-				DataBaseIOHandler(TransportCatalogue* catalogue);
-				~DataBaseIOHandler() = default;
-
-				void ProcessIOQueries(const json::Node& node_ref);
-
-			private:
-				size_t GetQueries(const json::Node& node_ref);
-				void ExecuteQuery(Query& query) override;
-				void PrintAnswers(std::ostream& output_stream = std::cout);
-
-				void PrintStopInfo(const details::StopInfo& info, const int id);
-				void PrintRouteInfo(const details::RouteInfo& info, const int id);
-				void PrintRouterBuildedInfo(
-					const std::optional<const transport_router::RouteInfo* const>&& info
-					, const int id
-				);
-
-				json::Array answer_{};
-				InputReader input_reader_{ &query_queue_ };
-			};
-		}//json_io
-	}//io_handler
-}//transport_catalogue
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "cassert"
+#include <deque>
+#include <forward_list>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <string>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "catalogue_snapshots.hpp"
+#include "geo.hpp"
+#include "transport_catalogue.hpp"
+#include "map_renderer.hpp"
+#include "json_builder.hpp"
+#include "string_interner.hpp"
+
+namespace transport_catalogue
+{
+	namespace configurator
+	{
+		enum class QueryType {
+			StopCreate,
+			RouteCreate,
+			DistanceSet,
+			MapRender,
+			InitRouter
+		};
+
+		struct StringViewPairHasher {
+			auto operator() (std::pair<std::string_view, std::string_view> pair) const -> size_t {
+				return std::hash<std::string_view>{}(pair.first) * 47
+					+ std::hash<std::string_view>{}(pair.second) * 47 * 47;
+			}
+		};
+
+		struct StopCreateQueryContent {
+			std::string_view name;
+			geo::Coordinates location;
+		};
+
+		struct RouteCreateQueryContent {
+			std::string_view name;
+			std::vector<std::string_view> stops_names;
+			bool is_round_trip;
+		};
+
+		struct DistanceSetQueryContent {
+			std::unordered_map<
+				std::pair<std::string_view, std::string_view>
+				, unsigned long, StringViewPairHasher
+			> distances;
+		};
+
+		struct InitRouterQueryContent {
+			unsigned int bus_wait_time;
+			unsigned int bus_velocity;
+			transport_router::RouterEngine engine;
+			size_t threads_count;
+			transport_router::GraphModel graph_model;
+			std::string cache_file;
+			size_t route_cache_bytes;
+		};
+
+		struct Query {
+			QueryType type;
+			std::variant<StopCreateQueryContent
+						, RouteCreateQueryContent
+						, DistanceSetQueryContent
+						, svg_renderer::RenderSettings
+						, InitRouterQueryContent
+			> content;
+			size_t order{ 0 }; //the queries of one type run in the order they were read
+		};
+
+		class QueryPtrCompare {
+		public:
+			bool operator() (const Query* lhs, const Query* rhs) const {
+				//StopCreate - highest priority
+				//DistanceSet - high priority
+				//RouteCreate - middle priority
+				//MapRender - low priority, the map is drawn from the routes of the catalogue
+				//InitRouter - lowest priority
+				//the ids of the stops and routes follow the input whatever other queries are queued
+				//, so a catalogue built with the router settings and one built without them are the same
+				if (lhs->type == rhs->type) {
+					return lhs->order > rhs->order;
+				}
+				if (lhs->type == QueryType::StopCreate) {
+					return false;
+				}
+				if (rhs->type == QueryType::StopCreate) {
+					return true;
+				}
+				if (lhs->type == QueryType::DistanceSet) {
+					return false;
+				}
+				if (rhs->type == QueryType::DistanceSet) {
+					return true;
+				}
+				if (lhs->type == QueryType::RouteCreate) {
+					return false;
+				}
+				if (rhs->type == QueryType::RouteCreate) {
+					return true;
+				}
+				if (rhs->type == QueryType::InitRouter) {
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class IInputReader {
+		public:
+			virtual ~IInputReader() = default;
+
+		protected:
+			//the query is kept in queries_ and queued by its priority
+			void PushQuery(Query&& query);
+			//folds the read base data into the checksum of the source data as it's read
+			void UpdateSourceChecksum(std::string_view bytes);
+			void UpdateSourceChecksum(double value);
+			void UpdateSourceChecksum(uint64_t value);
+
+			std::priority_queue<Query*, std::vector<Query*>, QueryPtrCompare>* query_ptr_queue_;
+			string_interner::StringInterner* names_; //the names of the catalogue, the queries refer to them
+
+			std::deque<Query>* queries_;
+			uint64_t* source_checksum_;
+		};
+
+		class IDataBaseConfigurator {
+		public:
+			virtual ~IDataBaseConfigurator() = default;
+
+		protected:
+			void ExecuteQueries();
+			void ExecuteQuery(Query& query);
+
+			TransportCatalogue* catalogue_;
+			std::priority_queue<Query*, std::vector<Query*>, QueryPtrCompare> query_ptr_queue_;
+			std::deque<Query> queries_;
+			//the base data the catalogue is made of. The router settings aren't folded in
+			//, the routes cache file compares them on their own
+			uint64_t source_checksum_{ 14695981039346656037ull }; //FNV-1a offset basis
+		};
+
+		namespace json_io
+		{
+			class InputReader : public IInputReader{
+			public:
+				InputReader(
+					std::priority_queue<Query*,std::vector<Query*>,QueryPtrCompare>* query_ref_queue
+					, std::deque<Query>* queries
+					, string_interner::StringInterner* names
+					, uint64_t* source_checksum
+				);
+
+				size_t ReadQueries(const json::Node& node);
+				void ProcessMapRenderQuery(const json::Node& node);
+				void ProcessInitRouterQuery(const json::Node& node);
+
+			private:
+				void ProcessStopQuery(const json::Node& node);
+				void ProcessRouteQuery(const json::Node& node);
+
+				std::vector<std::string_view> MakeRouteCircle(std::vector<std::string_view>&& stops);
+
+				svg_renderer::Color ParseColorFromJSON(const json::Node& node);
+				transport_router::RouterEngine ParseRouterEngineFromJSON(const json::Node& node);
+				transport_router::GraphModel ParseGraphModelFromJSON(const json::Node& node);
+				//a whole number within [min_size, max_size], the ones beyond int are read as doubles
+				size_t ParseSizeFromJSON(const json::Node& node, size_t min_size, size_t max_size, std::string_view setting);
+			};
+
+			class DataBaseConfigurator : public IDataBaseConfigurator {
+			public:
+				DataBaseConfigurator() = delete;
+				DataBaseConfigurator(TransportCatalogue* catalogue);
+				~DataBaseConfigurator() = default;
+
+				void SetCatalogue(const json::Node& node_ref);
+				//applies the base requests to a built catalogue: the stops and routes of the same names
+				//are replaced. The catalogue is left for the caller to finalize
+				void ChangeCatalogue(const json::Node& node_ref);
+				void ReadMapRenderQuery(const json::Node& node);
+				void ReadInitRouterQuery(const json::Node& node);
+
+				//loads the catalogue from the snapshot file in place of the base requests
+				//, then applies the settings read before it
+				void LoadSnapshot(const std::string& path);
+				//saves the catalogue set by SetCatalogue with the checksum of its source data
+				void SaveSnapshot(const std::string& path) const;
+
+			private:
+				size_t GetQueries(const json::Node& node_ref);
+				InputReader input_reader_;
+			};
+		}
+	}//configurator
+
+	namespace io_handler
+	{
+		enum class QueryType {
+			RouteInfo,
+			StopInfo,
+			DrawMap,
+			BuildRoute,
+			Reachable,
+			Matrix,
+			Nearest,
+			StopsInBox,
+			Update,
+			RouterStats
+		};
+
+		struct StopInfoQueryContent {
+			std::string name;
+		};
+
+		struct RouteInfoQueryContent {
+			std::string name;
+		};
+
+		struct BuildRouteQueryContent {
+			std::string from;
+			std::string to;
+		};
+
+		struct ReachableQueryContent {
+			std::string from;
+			double max_time;
+		};
+
+		struct MatrixQueryContent {
+			std::vector<std::string> from;
+			std::vector<std::string> to;
+			bool with_items;
+		};
+
+		struct NearestQueryContent {
+			geo::Coordinates location;
+			size_t count;
+		};
+
+		struct StopsInBoxQueryContent {
+			geo_index::GeoIndex::Box box;
+		};
+
+		struct UpdateQueryContent {
+			json::Node base_requests;
+		};
+
+		struct Query {
+			int id;
+			QueryType type;
+			std::variant<
+				StopInfoQueryContent
+				, RouteInfoQueryContent
+				, std::monostate
+				, BuildRouteQueryContent
+				, ReachableQueryContent
+				, MatrixQueryContent
+				, NearestQueryContent
+				, StopsInBoxQueryContent
+				, UpdateQueryContent
+			> content;
+		};
+
+		class IInputReader {
+		public:
+			virtual ~IInputReader() = default;
+
+		protected:
+			std::deque<Query>* query_queue_;
+		};
+
+		class IDataBaseIOHandler {
+		public:
+			virtual ~IDataBaseIOHandler() = default;
+
+		protected:
+			void ExecuteQueries();
+			virtual void ExecuteQuery(Query& query) = 0;
+
+			//builds the routes of the BuildRoute queries up to the next update as one batch
+			//, the answers are taken in the queries order
+			void PrefetchRoutes();
+
+			CatalogueSnapshots* snapshots_;
+			//the snapshot pinned for the queries up to the next update, all their answers come from it
+			CatalogueSnapshots::Snapshot catalogue_;
+			std::deque<Query> query_queue_;
+			std::deque<transport_router::RouteInfoPtr> prefetched_routes_;
+		};
+
+		namespace json_io
+		{
+			class InputReader : public IInputReader{
+			public:
+				InputReader(std::deque<Query>* query_queue);
+
+				size_t ReadQueries(const json::Node& node);
+
+				void ProcessDrawMapQuery(const json::Node& node);
+
+			private:
+				void ProcessRouteGetInfoQuery(const json::Node& node);
+				void ProcessStopGetInfoQuery(const json::Node& node);
+				void ProcessBuildRouteQuery(const json::Node& node);
+				void ProcessReachableQuery(const json::Node& node);
+				void ProcessMatrixQuery(const json::Node& node);
+				void ProcessNearestQuery(const json::Node& node);
+				void ProcessStopsInBoxQuery(const json::Node& node);
+				void ProcessUpdateQuery(const json::Node& node);
+				void ProcessRouterStatsQuery(const json::Node& node);
+			};
+
+			class DataBaseIOHandler : public IDataBaseIOHandler {
+			public:
+				DataBaseIOHandler() = delete;
+				DataBaseIOHandler(CatalogueSnapshots* snapshots);
+				~DataBaseIOHandler() = default;
+
+				void ProcessIOQueries(const json::Node& node_ref);
+
+			private:
+				size_t GetQueries(const json::Node& node_ref);
+				void ExecuteQuery(Query& query) override;
+				void PrintAnswers(std::ostream& output_stream = std::cout);
+
+				void PrintNotFound(const int id);
+				void PrintStopInfo(const details::StopInfo& info, const int id);
+				void PrintRouteInfo(const details::RouteInfo& info, const int id);
+				void PrintRouterBuildedInfo(
+					const transport_router::RouteInfoPtr& info
+					, const int id
+				);
+				void PrintReachableStops(
+					const std::vector<transport_router::ReachableStop>& stops
+					, const int id
+				);
+				void PrintTravelMatrix(
+					const transport_router::TravelMatrix& matrix
+					, const int id
+				);
+				void PrintNearestStops(
+					const std::vector<details::StopId>& stops
+					, geo::Coordinates location
+					, const int id
+				);
+				void PrintStopsInBox(
+					const std::vector<details::StopId>& stops
+					, const int id
+				);
+				void PrintRouterStats(
+					const ::graph::IRouter<double>::SearchStats& search_stats
+					, const lru_cache::CacheStats& cache_stats
+					, const int id
+				);
+				json::Array MakeRouteItems(const transport_router::RouteInfo& info) const;
+
+				json::Array answer_{};
+				InputReader input_reader_{ &query_queue_ };
+			};
+		}//json_io
+	}//io_handler
+}//transport_catalogue
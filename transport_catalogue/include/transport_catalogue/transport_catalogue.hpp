@@ -1,86 +1,209 @@
-#pragma once
-
-#include <algorithm>
-#include <forward_list>
-#include <memory>
-#include <optional>
-#include <stdexcept>
-#include <string>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
-
-#include "domain.hpp"
-#include "geo.hpp"
-#include "json.hpp"
-#include "transport_router.hpp"
-
-namespace transport_catalogue
-{	
-	class TransportCatalogue {
-		friend class size_t_wrapper::Wrapper::Builder<TransportCatalogue, size_t_wrapper::Wrapper>;
-
-	public:
-		using Vertex = const details::Stop* const;
-		using VertexHasher = details::StopPtrPairHasher;
-		using Cell = unsigned long;
-		using AdjacencyMatrix = std::unordered_map<std::pair<Vertex, Vertex>, Cell, VertexHasher>;
-
-	private:
-		using Router = transport_router::TransportRouter;
-
-	public:
-		TransportCatalogue() = default;
-		~TransportCatalogue();
-
-		void AddStop(std::string&& name, geo::Coordinates&& location);
-		void AddRoute(std::string&& name, std::vector<std::string_view>&& stops_names);
-
-		const details::Stop& GetStop(std::string_view name) const;
-		const details::Stop* GetStopPtr(std::string_view name) const;
-		size_t GetStopsCount() const;
-		const details::Route& GetRoute(std::string_view name) const;
-
-		const details::RouteInfo& GetRouteInfo(std::string_view name);
-		const details::StopInfo& GetStopInfo(std::string_view name);
-
-		void SetDistanceBetweenStops(
-			const details::Stop* const stop_from
-			, const details::Stop* const stop_to
-			, unsigned long distance
-		);
-		unsigned long GetDistanceBetweenStops(
-			const details::Stop* const stop_from
-			, const details::Stop* const stop_to
-		) const;
-
-		void InitRouter(Router::TransportRouterInitList&& init);
-		std::optional<const transport_router::RouteInfo* const> BuildRoute(
-			std::string_view from
-			, std::string_view to
-		);
-
-	private:
-		details::RouteInfo& SaveNewRouteInfo(std::string_view name);
-		[[nodiscard]] details::RouteInfo CreateRouteInfo(const details::Route* route_ptr);
-
-		details::StopInfo& SaveNewStopInfo(std::string_view name);
-		[[nodiscard]] details::StopInfo CreateStopInfo(const details::Stop* stop_ptr);
-
-		std::unordered_map<std::string_view, details::Stop> unique_stops_;
-		std::unordered_map<std::string_view, details::Route> unique_routes_;
-
-		std::unordered_map<std::string_view, details::RouteInfo> routes_info_;
-		std::unordered_map<std::string_view, details::StopInfo> stops_info_;
-
-		std::unordered_map<
-			std::string_view
-			, std::unordered_set<details::Route*, details::RoutePtrHasher>
-		> stops_to_routes_;
-
-		AdjacencyMatrix distance_graph_;
-		Router router_;
-
-		std::unordered_set<std::string> unique_names_;
-	};
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "distance_table.hpp"
+#include "domain.hpp"
+#include "geo.hpp"
+#include "geo_index.hpp"
+#include "json.hpp"
+#include "map_renderer.hpp"
+#include "mapped_array.hpp"
+#include "mapped_file.hpp"
+#include "perfect_hash.hpp"
+#include "string_interner.hpp"
+#include "transport_router.hpp"
+
+namespace transport_catalogue
+{	
+	class TransportCatalogue {
+	public:
+		using StopId = details::StopId;
+		using RouteId = details::RouteId;
+
+	private:
+		using Router = transport_router::TransportRouter;
+
+	public:
+		TransportCatalogue() = default;
+		~TransportCatalogue();
+
+		//the names are interned into the names of the catalogue, an interned name isn't copied again.
+		//A catalogue loaded from a snapshot can't be changed, the changes throw std::logic_error.
+		//The changes work after Finalize too: the stats, the router and the map are updated for the routes
+		//the change reaches, the answers it can't change stay cached. They aren't synchronized with the readers
+		//, so a catalogue is changed before it's published, a published one is changed through its Clone
+		void AddStop(std::string_view name, geo::Coordinates location);	//an added stop is moved
+		void AddRoute(std::string_view name, std::vector<std::string_view>&& stops_names, bool is_round_trip);	//an added route is replaced
+		void RemoveRoute(std::string_view name);
+		void MoveStop(std::string_view name, geo::Coordinates location);
+		void UpdateDistanceBetweenStops(std::string_view from, std::string_view to, unsigned long distance);
+
+		//the one copy of every name: the loaders intern the names here, so the catalogue takes them as they are
+		string_interner::StringInterner& GetNames();
+
+		//the ids index the arrays of the stops and routes, a removed route keeps its id with no stops
+		StopId GetStopId(std::string_view name) const;
+		RouteId GetRouteId(std::string_view name) const;
+		//nullopt for an unknown name, no exception is thrown
+		std::optional<StopId> FindStopId(std::string_view name) const;
+		std::optional<RouteId> FindRouteId(std::string_view name) const;
+		size_t GetStopsCount() const;
+		size_t GetRoutesCount() const;
+
+		std::string_view GetStopName(StopId stop) const;
+		const geo::Coordinates& GetStopLocation(StopId stop) const;
+		//the routes through the stop sorted by the names once the catalogue is finalized
+		//, in the order they were added before it
+		std::span<const RouteId> GetStopRoutes(StopId stop) const;
+		std::string_view GetRouteName(RouteId route) const;
+		bool IsRoundTrip(RouteId route) const;
+		//the stops in the riding order, a route that isn't a round trip goes there and back
+		std::span<const StopId> GetRouteStops(RouteId route) const;
+		//the road distance along the route between its stops at the indices, from_index <= to_index
+		unsigned long GetRouteDistance(RouteId route, size_t from_index, size_t to_index) const;
+
+		//computes the stats of all the routes in parallel, freezes the distances and indexes the names
+		//by perfect hashing once the data is loaded. The stats are kept up to date by the changes after it
+		//, before it they are computed on every query. A change of the names drops their index
+		//, the names are looked up in the hash maps until the next Finalize, which builds only the dropped indices
+		void Finalize(size_t threads_count = std::thread::hardware_concurrency());
+		bool IsFinalized() const;
+
+		//a changeable copy to build the next published catalogue of: the data, the indices, the map and the router
+		//with its engine and cached routes are copied, so the copy refers neither to this catalogue
+		//nor to its snapshot file
+		std::unique_ptr<TransportCatalogue> Clone() const;
+
+		//nullopt for an unknown name
+		std::optional<details::RouteInfo> GetRouteInfo(std::string_view name) const;
+		std::optional<details::StopInfo> GetStopInfo(std::string_view name) const;
+
+		//the stops are indexed in space by Finalize. A change of the stops drops the index
+		//, the stops are indexed anew for every query until the next Finalize.
+		//At most count stops ordered by the distance to the point
+		std::vector<StopId> FindNearestStops(geo::Coordinates point, size_t count) const;
+		//the stops in the box sorted by the names
+		std::vector<StopId> FindStopsInBox(const geo_index::GeoIndex::Box& box) const;
+
+		//the distances are kept in 32 bits, a longer one throws std::out_of_range
+		void SetDistanceBetweenStops(StopId stop_from, StopId stop_to, unsigned long distance);
+		unsigned long GetDistanceBetweenStops(StopId stop_from, StopId stop_to) const;
+
+		//The snapshot is a file of the finalized catalogue arrays, names, stats and names indices
+		//, saved as they are in memory: a loaded catalogue views them right in the mapped file
+		//, so nothing is parsed or copied, only the names views are made.
+		//The source checksum is saved with it to tell the router cache what data it was built of.
+		//The router and the map aren't saved: they depend on the settings, which come with the queries
+		void SaveSnapshot(const std::string& path, uint64_t source_checksum) const;
+		//loads an empty catalogue, returns the saved source checksum. Throws std::logic_error for a file
+		//that isn't a snapshot of this version and platform or is broken. Every id and range of the file
+		//is checked once, so the load reads all the pages with one sequential pass, which the queries find cached
+		uint64_t LoadSnapshot(const std::string& path);
+
+		void InitRouter(Router::TransportRouterInitList&& init);
+		transport_router::RouteInfoPtr BuildRoute(
+			std::string_view from
+			, std::string_view to
+		) const;
+		std::vector<transport_router::RouteInfoPtr> BuildRoutes(
+			const std::vector<transport_router::RouteRequest>& requests
+		) const;
+		std::vector<transport_router::ReachableStop> GetReachableStops(
+			std::string_view from
+			, double max_time
+		) const;
+		transport_router::TravelMatrix GetTravelMatrix(
+			const std::vector<std::string_view>& from
+			, const std::vector<std::string_view>& to
+			, bool with_routes
+		) const;
+		//the counters of the engine since it was made and of the routes cache, zeros without the router
+		::graph::IRouter<double>::SearchStats GetRouterSearchStats() const;
+		lru_cache::CacheStats GetRouteCacheStats() const;
+
+		//the map is a part of the catalogue, so a published catalogue answers with the map of its own data.
+		//The map is drawn from the routes present, the changes after it replace only the routes they reach
+		void SetRenderSettings(svg_renderer::RenderSettings&& settings);
+		void RenderMap(std::ostream& output_stream) const;
+
+	private:
+		struct StopsRange {
+			uint64_t begin;
+			uint64_t end;
+		};
+
+		//the stats of a route without its name, so they are saved as they are
+		struct RouteStats {
+			uint64_t distance_total;
+			double curvature;
+			uint32_t stops_count;
+			uint32_t unique_stops_count;
+			uint32_t is_computed; //0 for a route with no stats computed
+		};
+
+		[[nodiscard]] details::RouteInfo CreateRouteInfo(RouteId route) const;
+		[[nodiscard]] static RouteStats CreateRouteStats(const details::RouteInfo& info);
+		void ComputeRouteDistances(RouteId route);
+		void UpdateRouteInfo(RouteId route);
+		std::vector<RouteId> FindRoutesThrough(StopId stop_from, StopId stop_to) const;
+		void FreezeStopsRoutes();
+		//the names and the spatial indices that are missing
+		void BuildIndices();
+		void CheckIsChangeable() const;
+		svg_renderer::RouteData CreateRenderRoute(RouteId route) const;
+		//the sizes of the saved records, a snapshot of another layout is rejected
+		static uint64_t GetSnapshotLayout();
+
+		//the arrays of a catalogue loaded from a snapshot view the mapped file
+		std::optional<mapped_file::MappedFile> snapshot_mapping_;
+
+		//stops
+		std::vector<std::string_view> stops_names_;
+		mapped_file::MappedArray<geo::Coordinates> stops_locations_;
+		//the routes through every stop while the data is loaded, sorted by the names and frozen into one array
+		//by Finalize: the routes of the stop i are at [offsets[i], offsets[i + 1])
+		std::vector<std::vector<RouteId>> stops_routes_;
+		mapped_file::MappedArray<uint32_t> stops_routes_offsets_;
+		mapped_file::MappedArray<RouteId> stops_routes_ids_;
+		std::unordered_map<std::string_view, StopId> stops_ids_;
+
+		//routes
+		//no road distance to the stop: one of the steps before it is missing
+		static constexpr uint64_t NO_DISTANCE{ std::numeric_limits<uint64_t>::max() };
+
+		std::vector<std::string_view> routes_names_;
+		mapped_file::MappedArray<uint8_t> routes_round_trips_;
+		//the stops of all the routes one after another, a route refers to its range.
+		//The prefix sums follow the stops: the road and the geographical distances from the route start
+		mapped_file::MappedArray<StopsRange> routes_ranges_;
+		mapped_file::MappedArray<StopId> routes_stops_;
+		mapped_file::MappedArray<uint64_t> routes_distances_;
+		mapped_file::MappedArray<double> routes_geo_distances_;
+		mapped_file::MappedArray<RouteStats> routes_stats_;
+		std::unordered_map<std::string_view, RouteId> routes_ids_;
+
+		//the frozen names indices and the stops spatial index built by Finalize
+		std::optional<perfect_hash::NameIndex> stops_index_;
+		std::optional<perfect_hash::NameIndex> routes_index_;
+		std::optional<geo_index::GeoIndex> stops_geo_index_;
+
+		DistanceTable distances_;
+		Router router_;
+		svg_renderer::Renderer renderer_;
+
+		string_interner::StringInterner names_;
+		bool is_finalized_{ false };
+	};
 }//transport_catalogue
\ No newline at end of file
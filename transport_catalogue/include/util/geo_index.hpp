@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#include "geo.hpp"
+#include "mapped_array.hpp"
+
+namespace geo_index {
+
+    // Frozen k-d tree over points on the sphere. The points are kept as unit vectors, so the straight
+    // distance between them grows with the distance along the sphere and the nearest points are found
+    // with the usual splitting planes, with no trouble at the poles or the 180th meridian.
+    // The tree is implicit: the node of a range of the array is its middle element, the halves
+    // around it are the subtrees. Every node keeps the latitude and longitude bounds of its subtree,
+    // so a box query skips the subtrees out of the box and takes whole the ones inside it.
+    // The nodes keep no pointers, so the tree can be viewed right in a mapped file
+    class GeoIndex {
+    public:
+        using Id = uint32_t;
+
+        // the box with min_lng > max_lng crosses the 180th meridian
+        struct Box {
+            double min_lat;
+            double max_lat;
+            double min_lng;
+            double max_lng;
+        };
+
+        struct Node {
+            double point[3];        // the unit vector
+            geo::Coordinates location;
+            Box bounds;             // of the subtree
+            Id id;
+            uint32_t axis;          // of the splitting plane
+        };
+
+        GeoIndex() = default;
+        // the ids are the indices of the locations
+        explicit GeoIndex(std::span<const geo::Coordinates> locations);
+        // views the array given out by GetNodes
+        explicit GeoIndex(std::span<const Node> nodes);
+
+        // at most count ids ordered by the distance to the point, the equal ones by the id.
+        // O(log n + count) for the points spread evenly
+        std::vector<Id> FindNearest(geo::Coordinates point, size_t count) const;
+        // the ids of the points in the box, bounds included, in no particular order
+        std::vector<Id> FindInBox(const Box& box) const;
+        size_t GetSize() const;
+
+        std::span<const Node> GetNodes() const;
+
+    private:
+        mapped_file::MappedArray<Node> nodes_;
+    };
+
+}  // namespace geo_index
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lru_cache {
+
+    struct CacheStats {
+        size_t hits_count = 0;
+        size_t misses_count = 0;
+        size_t evictions_count = 0;
+        size_t invalidations_count = 0;
+        size_t entries_count = 0;
+        size_t bytes_used = 0;
+    };
+
+    // Cache of shared immutable values bounded by a budget of bytes.
+    // The keys are spread over shards, each one with its own lock, list of entries in the order
+    // of use and an equal part of the budget. When a shard is over its part, the least recently
+    // used entries are evicted. The values are shared, so an evicted value stays valid for its holders
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class ShardedLruCache {
+    public:
+        using ValuePtr = std::shared_ptr<const Value>;
+
+        explicit ShardedLruCache(size_t bytes_budget = 0, size_t shards_count = 16);
+
+        // nullptr if there is no such key
+        ValuePtr Get(const Key& key);
+        // bytes is the memory taken by the value, the bookkeeping of the entry is added to it.
+        // A value larger than the budget of a shard isn't kept
+        void Put(const Key& key, ValuePtr value, size_t bytes);
+        // drops the entries the predicate(key, value) is true for, returns their count
+        size_t EraseIf(const std::function<bool(const Key&, const Value&)>& predicate);
+        void Clear();
+        // calls action(key, value) for every entry, the least recently used of a shard first,
+        // so putting them in that order into a cache of the same shards keeps their order of use
+        void ForEach(const std::function<void(const Key&, const ValuePtr&)>& action) const;
+
+        CacheStats GetStats() const;
+
+    private:
+        struct Entry {
+            Key key;
+            ValuePtr value;
+            size_t bytes;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<Entry> entries; //the most recently used first
+            std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> positions;
+            size_t bytes_used = 0;
+        };
+
+        Shard& GetShard(const Key& key);
+
+        // the list node, the map node and its bucket
+        static constexpr size_t ENTRY_OVERHEAD_BYTES = sizeof(Entry) + 2 * sizeof(void*)
+            + sizeof(std::pair<const Key, typename std::list<Entry>::iterator>) + 2 * sizeof(void*);
+
+        Hash hash_;
+        size_t shard_bytes_budget_;
+        std::vector<Shard> shards_;
+
+        std::atomic<size_t> hits_count_{ 0 };
+        std::atomic<size_t> misses_count_{ 0 };
+        std::atomic<size_t> evictions_count_{ 0 };
+        std::atomic<size_t> invalidations_count_{ 0 };
+    };
+
+    template <typename Key, typename Value, typename Hash>
+    ShardedLruCache<Key, Value, Hash>::ShardedLruCache(size_t bytes_budget, size_t shards_count)
+        : shard_bytes_budget_(bytes_budget / std::max<size_t>(shards_count, 1))
+        , shards_(std::max<size_t>(shards_count, 1))
+    {
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    typename ShardedLruCache<Key, Value, Hash>::ValuePtr ShardedLruCache<Key, Value, Hash>::Get(const Key& key) {
+        Shard& shard = GetShard(key);
+        std::lock_guard lock{ shard.mutex };
+        auto it = shard.positions.find(key);
+        if (it == shard.positions.end()) {
+            misses_count_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        hits_count_.fetch_add(1, std::memory_order_relaxed);
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->value;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    void ShardedLruCache<Key, Value, Hash>::Put(const Key& key, ValuePtr value, size_t bytes) {
+        bytes += ENTRY_OVERHEAD_BYTES;
+        if (bytes > shard_bytes_budget_) {
+            return;
+        }
+
+        Shard& shard = GetShard(key);
+        std::lock_guard lock{ shard.mutex };
+        if (auto it = shard.positions.find(key); it != shard.positions.end()) {
+            shard.bytes_used -= it->second->bytes;
+            shard.entries.erase(it->second);
+            shard.positions.erase(it);
+        }
+
+        while (shard.bytes_used + bytes > shard_bytes_budget_) {
+            const Entry& evicted = shard.entries.back();
+            shard.bytes_used -= evicted.bytes;
+            shard.positions.erase(evicted.key);
+            shard.entries.pop_back();
+            evictions_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shard.entries.push_front(Entry{ key, std::move(value), bytes });
+        shard.positions.emplace(key, shard.entries.begin());
+        shard.bytes_used += bytes;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    size_t ShardedLruCache<Key, Value, Hash>::EraseIf(const std::function<bool(const Key&, const Value&)>& predicate) {
+        size_t erased_count = 0;
+        for (Shard& shard : shards_) {
+            std::lock_guard lock{ shard.mutex };
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                if (!predicate(it->key, *it->value)) {
+                    ++it;
+                    continue;
+                }
+                shard.bytes_used -= it->bytes;
+                shard.positions.erase(it->key);
+                it = shard.entries.erase(it);
+                ++erased_count;
+            }
+        }
+        invalidations_count_.fetch_add(erased_count, std::memory_order_relaxed);
+        return erased_count;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    void ShardedLruCache<Key, Value, Hash>::Clear() {
+        EraseIf([](const Key&, const Value&) { return true; });
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    void ShardedLruCache<Key, Value, Hash>::ForEach(const std::function<void(const Key&, const ValuePtr&)>& action) const {
+        for (const Shard& shard : shards_) {
+            std::lock_guard lock{ shard.mutex };
+            for (auto it = shard.entries.rbegin(); it != shard.entries.rend(); ++it) {
+                action(it->key, it->value);
+            }
+        }
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    CacheStats ShardedLruCache<Key, Value, Hash>::GetStats() const {
+        CacheStats stats{
+            .hits_count = hits_count_.load(std::memory_order_relaxed)
+            , .misses_count = misses_count_.load(std::memory_order_relaxed)
+            , .evictions_count = evictions_count_.load(std::memory_order_relaxed)
+            , .invalidations_count = invalidations_count_.load(std::memory_order_relaxed)
+        };
+        for (const Shard& shard : shards_) {
+            std::lock_guard lock{ shard.mutex };
+            stats.entries_count += shard.entries.size();
+            stats.bytes_used += shard.bytes_used;
+        }
+        return stats;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    typename ShardedLruCache<Key, Value, Hash>::Shard& ShardedLruCache<Key, Value, Hash>::GetShard(const Key& key) {
+        //the high bits are mixed in, so the shards don't take the same low bits as the buckets of their maps
+        const size_t hash = hash_(key);
+        return shards_[(hash ^ (hash >> 17) ^ (hash >> 31)) % shards_.size()];
+    }
+
+}  // namespace lru_cache
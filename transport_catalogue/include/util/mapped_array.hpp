@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdlib>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mapped_file {
+
+    // Array kept in a vector of its own or viewed right in the pages of a mapped file.
+    // It's read the same way in both cases, so the code reading it doesn't care where it lives.
+    // A viewed array is copied into a vector by the first change, the file is never written.
+    // A copy always owns its values, so it outlives the file; a move keeps the view
+    template <typename T>
+    class MappedArray {
+    public:
+        MappedArray() = default;
+        MappedArray(std::vector<T> values)
+            : values_(std::move(values))
+        {
+        }
+        MappedArray(const MappedArray& other)
+            : values_(other.begin(), other.end())
+        {
+        }
+        MappedArray& operator=(const MappedArray& other) {
+            if (this != &other) {
+                values_.assign(other.begin(), other.end());
+                view_ = {};
+                is_view_ = false;
+            }
+            return *this;
+        }
+        MappedArray(MappedArray&&) noexcept = default;
+        MappedArray& operator=(MappedArray&&) noexcept = default;
+
+        // the view has to outlive the array, the file mapping is kept by the owner of the array
+        static MappedArray View(std::span<const T> view) {
+            MappedArray array;
+            array.view_ = view;
+            array.is_view_ = true;
+            return array;
+        }
+
+        const T* data() const {
+            return is_view_ ? view_.data() : values_.data();
+        }
+        size_t size() const {
+            return is_view_ ? view_.size() : values_.size();
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        const T* begin() const {
+            return data();
+        }
+        const T* end() const {
+            return data() + size();
+        }
+        const T& operator[](size_t index) const {
+            return data()[index];
+        }
+        const T& back() const {
+            return data()[size() - 1];
+        }
+        operator std::span<const T>() const {
+            return { data(), size() };
+        }
+
+        std::vector<T>& Mutable() {
+            if (is_view_) {
+                values_.assign(view_.begin(), view_.end());
+                view_ = {};
+                is_view_ = false;
+            }
+            return values_;
+        }
+
+    private:
+        std::vector<T> values_;
+        std::span<const T> view_;
+        bool is_view_ = false;
+    };
+
+}  // namespace mapped_file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mapped_file {
+
+    // Read-only view of a whole file. On POSIX systems the file is mapped into memory,
+    // so its pages are loaded on first access and shared between processes,
+    // elsewhere its content is read into a buffer.
+    // The data is aligned at least to alignof(std::max_align_t)
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        // std::nullopt if the file can't be opened
+        static std::optional<MappedFile> Open(const std::string& path);
+
+        const std::byte* GetData() const;
+        size_t GetSize() const;
+
+    private:
+        void Close();
+
+        const std::byte* data_ = nullptr;
+        size_t size_ = 0;
+        bool is_mapped_ = false;
+        std::vector<std::max_align_t> buffer_; //fallback storage
+    };
+
+    // Writes arrays one after another, each one aligned for its type,
+    // so ArraysReader views them right in a mapped file
+    class ArraysWriter {
+    public:
+        explicit ArraysWriter(std::ostream& output)
+            : output_(output)
+        {
+        }
+
+        template <typename T>
+        void Write(std::span<const T> values) {
+            Align(alignof(T));
+            output_.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+            offset_ += values.size_bytes();
+        }
+
+        template <typename T>
+        void Write(const T& value) {
+            Write(std::span<const T>{ &value, 1 });
+        }
+
+    private:
+        void Align(size_t alignment) {
+            for (; offset_ % alignment != 0; ++offset_) {
+                output_.put('\0');
+            }
+        }
+
+        std::ostream& output_;
+        size_t offset_ = 0;
+    };
+
+    // Views the arrays written by ArraysWriter in the order they were written
+    class ArraysReader {
+    public:
+        ArraysReader(const std::byte* data, size_t size)
+            : data_(data)
+            , size_(size)
+        {
+        }
+
+        // std::nullopt if the data is too short
+        template <typename T>
+        std::optional<std::span<const T>> Read(uint64_t count) {
+            offset_ = (offset_ + alignof(T) - 1) / alignof(T) * alignof(T);
+            if (offset_ > size_ || count > (size_ - offset_) / sizeof(T)) {
+                return std::nullopt;
+            }
+            std::span<const T> values{ reinterpret_cast<const T*>(data_ + offset_), static_cast<size_t>(count) };
+            offset_ += values.size_bytes();
+            return values;
+        }
+
+    private:
+        const std::byte* data_;
+        size_t size_;
+        size_t offset_ = 0;
+    };
+
+}  // namespace mapped_file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mapped_array.hpp"
+
+namespace perfect_hash {
+
+    // Frozen map of distinct names to ids, built by hash and displace: the names are spread over
+    // small buckets, and every bucket gets a seed that sends its names to free slots of a table
+    // exactly as large as the set of names. A lookup reads the seed of its bucket, probes one slot
+    // and compares the name of the id there. The full hash is kept in the slot, so most unknown names
+    // are rejected by the hash compare without reading a name.
+    // The index keeps no names and no pointers, and the names are hashed with FNV-1a on every platform,
+    // so it can be viewed right in a mapped file, even one saved by another build
+    class NameIndex {
+    public:
+        using Id = uint32_t;
+
+        struct Slot {
+            uint64_t hash;
+            Id id;
+        };
+
+        NameIndex() = default;
+        // the names have to be distinct
+        explicit NameIndex(const std::vector<std::pair<std::string_view, Id>>& entries);
+        // views the arrays given out by GetSeeds and GetSlots
+        NameIndex(std::span<const uint32_t> seeds, std::span<const Slot> slots);
+
+        // names are the names of the ids. std::nullopt for a name that wasn't given
+        std::optional<Id> Find(std::string_view name, std::span<const std::string_view> names) const;
+        size_t GetSize() const;
+
+        std::span<const uint32_t> GetSeeds() const;
+        std::span<const Slot> GetSlots() const;
+
+    private:
+        static uint64_t Hash(std::string_view name);
+        size_t GetBucket(uint64_t hash) const;
+        size_t GetSlot(uint64_t hash, uint32_t seed) const;
+
+        mapped_file::MappedArray<uint32_t> seeds_;
+        mapped_file::MappedArray<Slot> slots_;
+    };
+
+}  // namespace perfect_hash
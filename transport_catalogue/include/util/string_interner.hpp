@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace string_interner {
+
+    // Keeps one copy of every distinct string, packed one after another into large blocks.
+    // The views given out stay valid as long as the interner, moves included: a block is never
+    // reallocated, and a string longer than a block gets a block of its own.
+    // The index of the strings is an open addressing table of views, so no string takes an allocation
+    class StringInterner {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        explicit StringInterner(size_t block_size = DEFAULT_BLOCK_SIZE);
+        StringInterner(const StringInterner&) = delete;
+        StringInterner& operator=(const StringInterner&) = delete;
+        StringInterner(StringInterner&&) noexcept = default;
+        StringInterner& operator=(StringInterner&&) noexcept = default;
+
+        // the kept copy of the string, a new string is copied in first
+        std::string_view Intern(std::string_view str);
+        // the kept copy, std::nullopt for a string that isn't interned
+        std::optional<std::string_view> Find(std::string_view str) const;
+
+        size_t GetStringsCount() const;
+        // the bytes taken by the blocks
+        size_t GetBytesCount() const;
+
+    private:
+        struct Slot {
+            size_t hash;
+            const char* data = nullptr; // nullptr for an empty slot
+            size_t size = 0;
+        };
+
+        const Slot* FindSlot(std::string_view str, size_t hash) const;
+        const char* Store(std::string_view str);
+        void Grow();
+
+        size_t block_size_;
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char* current_block_ = nullptr;
+        size_t block_used_ = 0;
+        size_t bytes_count_ = 0;
+
+        std::vector<Slot> slots_;
+        size_t strings_count_ = 0;
+    };
+
+}  // namespace string_interner
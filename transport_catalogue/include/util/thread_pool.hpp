@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace thread_pool {
+
+    // Fixed set of worker threads for data-parallel loops.
+    // The calling thread takes part in every loop too, so a pool of N threads has N - 1 workers
+    class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threads_count = std::thread::hardware_concurrency());
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool();
+
+        size_t GetThreadsCount() const;
+
+        // Runs task(index) for every index in [0, count) and returns when all of them are done.
+        // The first exception thrown by a task is rethrown to the caller.
+        // A loop started from inside a task of the same pool runs sequentially
+        void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    private:
+        void WorkerLoop();
+        void RunTasks();
+
+        std::vector<std::thread> workers_;
+
+        std::mutex loop_mutex_; //one loop at a time
+        std::mutex mutex_;
+        std::condition_variable work_available_;
+        std::condition_variable work_done_;
+
+        const std::function<void(size_t)>* task_ = nullptr;
+        size_t count_ = 0;
+        std::atomic<size_t> next_index_{ 0 };
+        size_t busy_workers_ = 0;
+        size_t generation_ = 0;
+        bool stopping_ = false;
+        std::exception_ptr exception_;
+    };
+
+}  // namespace thread_pool
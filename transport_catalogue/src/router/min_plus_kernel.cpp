@@ -0,0 +1,135 @@
+#include "min_plus_kernel.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MIN_PLUS_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+    namespace {
+        using KernelFunction = void (*)(size_t, float, uint32_t, uint32_t
+            , const float*, const uint32_t*, float*, uint32_t*);
+
+        void RelaxRoutesRowScalar(size_t count, float weight_from, uint32_t prev_edge_from, uint32_t no_edge
+            , const float* weights_through, const uint32_t* prev_edges_through
+            , float* weights_relaxing, uint32_t* prev_edges_relaxing) {
+            for (size_t i = 0; i < count; ++i) {
+                const float candidate_weight = weight_from + weights_through[i];
+                if (candidate_weight < weights_relaxing[i]) {
+                    weights_relaxing[i] = candidate_weight;
+                    prev_edges_relaxing[i] = prev_edges_through[i] != no_edge ? prev_edges_through[i] : prev_edge_from;
+                }
+            }
+        }
+
+#ifdef MIN_PLUS_KERNEL_X86
+        __attribute__((target("avx2")))
+        void RelaxRoutesRowAvx2(size_t count, float weight_from, uint32_t prev_edge_from, uint32_t no_edge
+            , const float* weights_through, const uint32_t* prev_edges_through
+            , float* weights_relaxing, uint32_t* prev_edges_relaxing) {
+            const __m256 weight_from_v = _mm256_set1_ps(weight_from);
+            const __m256i prev_edge_from_v = _mm256_set1_epi32(static_cast<int>(prev_edge_from));
+            const __m256i no_edge_v = _mm256_set1_epi32(static_cast<int>(no_edge));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256 weights_relaxing_v = _mm256_loadu_ps(weights_relaxing + i);
+                const __m256 candidates_v = _mm256_add_ps(weight_from_v, _mm256_loadu_ps(weights_through + i));
+                const __m256 improved_v = _mm256_cmp_ps(candidates_v, weights_relaxing_v, _CMP_LT_OQ);
+                if (_mm256_movemask_ps(improved_v) == 0) {
+                    continue;
+                }
+
+                const __m256i prev_edges_through_v = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(prev_edges_through + i));
+                const __m256i new_prev_edges_v = _mm256_blendv_epi8(prev_edges_through_v, prev_edge_from_v
+                    , _mm256_cmpeq_epi32(prev_edges_through_v, no_edge_v));
+                const __m256i prev_edges_relaxing_v = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(prev_edges_relaxing + i));
+
+                _mm256_storeu_ps(weights_relaxing + i, _mm256_blendv_ps(weights_relaxing_v, candidates_v, improved_v));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges_relaxing + i)
+                    , _mm256_blendv_epi8(prev_edges_relaxing_v, new_prev_edges_v, _mm256_castps_si256(improved_v)));
+            }
+
+            RelaxRoutesRowScalar(count - i, weight_from, prev_edge_from, no_edge
+                , weights_through + i, prev_edges_through + i, weights_relaxing + i, prev_edges_relaxing + i);
+        }
+
+        __attribute__((target("sse4.1")))
+        void RelaxRoutesRowSse41(size_t count, float weight_from, uint32_t prev_edge_from, uint32_t no_edge
+            , const float* weights_through, const uint32_t* prev_edges_through
+            , float* weights_relaxing, uint32_t* prev_edges_relaxing) {
+            const __m128 weight_from_v = _mm_set1_ps(weight_from);
+            const __m128i prev_edge_from_v = _mm_set1_epi32(static_cast<int>(prev_edge_from));
+            const __m128i no_edge_v = _mm_set1_epi32(static_cast<int>(no_edge));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128 weights_relaxing_v = _mm_loadu_ps(weights_relaxing + i);
+                const __m128 candidates_v = _mm_add_ps(weight_from_v, _mm_loadu_ps(weights_through + i));
+                const __m128 improved_v = _mm_cmplt_ps(candidates_v, weights_relaxing_v);
+                if (_mm_movemask_ps(improved_v) == 0) {
+                    continue;
+                }
+
+                const __m128i prev_edges_through_v = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(prev_edges_through + i));
+                const __m128i new_prev_edges_v = _mm_blendv_epi8(prev_edges_through_v, prev_edge_from_v
+                    , _mm_cmpeq_epi32(prev_edges_through_v, no_edge_v));
+                const __m128i prev_edges_relaxing_v = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(prev_edges_relaxing + i));
+
+                _mm_storeu_ps(weights_relaxing + i, _mm_blendv_ps(weights_relaxing_v, candidates_v, improved_v));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(prev_edges_relaxing + i)
+                    , _mm_blendv_epi8(prev_edges_relaxing_v, new_prev_edges_v, _mm_castps_si128(improved_v)));
+            }
+
+            RelaxRoutesRowScalar(count - i, weight_from, prev_edge_from, no_edge
+                , weights_through + i, prev_edges_through + i, weights_relaxing + i, prev_edges_relaxing + i);
+        }
+#endif
+
+        MinPlusKernel DetectMinPlusKernel() {
+#ifdef MIN_PLUS_KERNEL_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return MinPlusKernel::Avx2;
+            }
+            if (__builtin_cpu_supports("sse4.1")) {
+                return MinPlusKernel::Sse41;
+            }
+#endif
+            return MinPlusKernel::Scalar;
+        }
+
+        KernelFunction GetKernelFunction(MinPlusKernel kernel) {
+            switch (kernel) {
+#ifdef MIN_PLUS_KERNEL_X86
+            case MinPlusKernel::Avx2:
+                return RelaxRoutesRowAvx2;
+            case MinPlusKernel::Sse41:
+                return RelaxRoutesRowSse41;
+#endif
+            default:
+                return RelaxRoutesRowScalar;
+            }
+        }
+
+        const MinPlusKernel min_plus_kernel = DetectMinPlusKernel();
+        const KernelFunction kernel_function = GetKernelFunction(min_plus_kernel);
+    }
+
+    void RelaxRoutesRowMinPlus(size_t count, float weight_from, uint32_t prev_edge_from, uint32_t no_edge
+        , const float* weights_through, const uint32_t* prev_edges_through
+        , float* weights_relaxing, uint32_t* prev_edges_relaxing) {
+        kernel_function(count, weight_from, prev_edge_from, no_edge
+            , weights_through, prev_edges_through, weights_relaxing, prev_edges_relaxing);
+    }
+
+    MinPlusKernel GetMinPlusKernel() {
+        return min_plus_kernel;
+    }
+
+}  // namespace graph
@@ -0,0 +1,66 @@
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "router.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+//router_bench [vertex_count] [max_threads] [edges_per_vertex]
+//builds the Floyd-Warshall table of a random graph with 1..max_threads threads and prints the times.
+//The weights are whole numbers, so every thread count has to give the very same table
+int main(int argc, char* argv[]) {
+    const size_t vertex_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+        : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t edges_per_vertex = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+    if (vertex_count == 0 || max_threads == 0) {
+        std::cerr << "Usage: " << argv[0] << " [vertex_count] [max_threads] [edges_per_vertex]" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 generator{ 42 };
+    std::uniform_int_distribution<size_t> vertex_distribution{ 0, vertex_count - 1 };
+    std::uniform_int_distribution<int> weight_distribution{ 1, 100 };
+    graph::DirectedWeightedGraph<double> graph{ vertex_count };
+    for (graph::VertexId from = 0; from < vertex_count; ++from) {
+        for (size_t i = 0; i < edges_per_vertex; ++i) {
+            graph.AddEdge({ from, vertex_distribution(generator), static_cast<double>(weight_distribution(generator)) });
+        }
+    }
+    const graph::CsrGraph<double> csr_graph{ graph };
+
+    std::cout << "vertices: " << vertex_count << ", edges: " << graph.GetEdgeCount() << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "ms" << std::setw(10) << "speedup" << std::endl;
+
+    std::vector<float> reference_weights;
+    std::vector<uint32_t> reference_prev_edges;
+    double single_thread_ms = 0.0;
+    bool is_same = true;
+    for (size_t threads_count = 1; threads_count <= max_threads; ++threads_count) {
+        const auto start = std::chrono::steady_clock::now();
+        const graph::Router<double> router{ csr_graph, threads_count };
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        const auto table = router.GetRoutesTable();
+        if (threads_count == 1) {
+            single_thread_ms = elapsed.count();
+            reference_weights.assign(table.weights.begin(), table.weights.end());
+            reference_prev_edges.assign(table.prev_edges.begin(), table.prev_edges.end());
+        }
+        else if (!std::ranges::equal(table.weights, reference_weights)
+            || !std::ranges::equal(table.prev_edges, reference_prev_edges)) {
+            std::cerr << "the table of " << threads_count << " threads differs from the single thread one" << std::endl;
+            is_same = false;
+        }
+
+        std::cout << std::setw(8) << threads_count
+            << std::setw(12) << std::fixed << std::setprecision(1) << elapsed.count()
+            << std::setw(10) << std::setprecision(2) << single_thread_ms / elapsed.count() << std::endl;
+    }
+    return is_same ? 0 : 1;
+}
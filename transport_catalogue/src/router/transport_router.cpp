@@ -1,67 +1,915 @@
-#include "transport_router.hpp"
-#include "transport_catalogue.hpp"
-
-namespace transport_router
-{
-	void TransportRouter::Init(TransportRouterInitList&& init) {
-		bus_velocity_ = init.bus_velocity;
-		bus_wait_time_ = init.bus_wait_time;
-		catalogue_ = init.catalogue;
-
-		graph_ = ::graph::DirectedWeightedGraph<double>{ catalogue_->GetStopsCount() };
-		SetGraphWithRoutes();
-		router_uptr_.reset(new ::graph::Router<double>{ graph_ });
-	}
-
-	std::optional<const RouteInfo* const> TransportRouter::GetRouteInfo(std::string_view from, std::string_view to) {
-		auto stop_from_ptr{ catalogue_->GetStopPtr(from) };
-		auto stop_to_ptr{ catalogue_->GetStopPtr(to) };
-		std::optional<size_t> vertex_from{ wrapper_uptr_->WrapVertex(stop_from_ptr) };
-		std::optional<size_t> vertex_to{ wrapper_uptr_->WrapVertex(stop_to_ptr) };
-
-		if (!vertex_from || !vertex_to) {
-			return std::nullopt;
-		}
-
-		if (routes_info_.contains({ vertex_from.value(), vertex_to.value() })) {
-			return &(routes_info_[{ vertex_from.value(), vertex_to.value()}]);
-		}
-
-		return CreateAndSaveNewRouteInfo(vertex_from.value(), vertex_to.value());
-	}
-
-	std::optional<const RouteInfo* const> TransportRouter::CreateAndSaveNewRouteInfo(size_t from, size_t to) {
-		auto raw_info{ router_uptr_->BuildRoute(from, to) };
-		if (!raw_info) {
-			return std::nullopt;
-		}
-
-		std::vector<Item> items;
-		for (const auto edge_id : raw_info.value().edges) {
-			auto item_info = wrapper_uptr_->UnwrapEdge(edge_id);
-			WaitItem wait_item{ .stop_name = item_info.wait_stop_name, .time = bus_wait_time_ };
-			items.push_back({ std::move(wait_item) });
-			BusItem bus_item{ .bus = item_info.bus_name, .span_count = item_info.span_count, .time = item_info.time };
-			items.push_back({ std::move(bus_item) });
-		}
-
-		routes_info_.insert(
-			{ { from, to }
-			, RouteInfo{.total_time = raw_info.value().weight, .items = std::move(items) }
-			});
-
-		return std::optional<const RouteInfo* const>{ &routes_info_.at({ from, to }) };
-	}
-
-	void TransportRouter::SetGraphWithRoutes() {
-		auto builder = Wrapper::Builder<Catalogue, Wrapper>{
-			{
-				.catalogue = *catalogue_,
-				.graph = graph_,
-				.bus_wait_time = bus_wait_time_,
-				.bus_velocity = bus_velocity_
-			}
-		};
-		wrapper_uptr_ = builder.Make();
-	}
+#include "transport_router.hpp"
+#include "transport_catalogue.hpp"
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <span>
+
+namespace transport_router
+{
+	namespace
+	{
+		//the cache file is a header followed by the arrays, each one aligned for its type:
+		//names offsets and chars, vertices, the CSR offsets, arcs and edges, edges info
+		//and, for the Floyd-Warshall engine, the routes table weights and previous edges
+		//or, for the contraction hierarchies engine, the contracted edges and the vertex ranks.
+		//The other engines keep nothing worth saving and build their searches on demand
+		constexpr std::array<char, 8> CACHE_MAGIC{ 'T', 'C', 'R', 'O', 'U', 'T', 'E', 'R' };
+		constexpr uint32_t CACHE_VERSION{ 2 }; //2: the contraction hierarchy is saved
+		constexpr uint32_t NO_NAME{ std::numeric_limits<uint32_t>::max() };
+
+		using Arc = ::graph::CsrGraph<double>::Arc;
+		using Edge = ::graph::Edge<double>;
+		using FloydWarshallRouter = ::graph::Router<double>;
+		using ContractionHierarchiesRouter = ::graph::ContractionHierarchiesRouter<double>;
+
+		//the arrays are saved as they are in memory, so a file of another platform is rejected
+		//: the sizes differ or the value is read with the other byte order
+		constexpr uint32_t CACHE_LAYOUT{ sizeof(size_t) | sizeof(Arc) << 8 | sizeof(Edge) << 16 };
+
+		struct CacheHeader {
+			std::array<char, 8> magic;
+			uint32_t version;
+			uint32_t layout;
+			uint64_t source_checksum;
+			uint32_t engine;
+			uint32_t graph_model;
+			uint32_t bus_wait_time;
+			uint32_t bus_velocity;
+			uint64_t vertex_count;
+			uint64_t edge_count;
+			uint64_t names_count;
+			uint64_t names_size;
+			uint64_t has_routes_table;
+			uint64_t hierarchy_edge_count; //0 unless the hierarchy is saved
+		};
+
+		struct VertexRecord {
+			uint32_t name;	//NO_NAME for a vertex without a stop
+			uint32_t is_stop;	//0 for a ride vertex of the transfers model
+		};
+
+		struct EdgeRecord {
+			uint32_t bus_name;
+			uint32_t wait_stop_name;
+			uint32_t span_count;
+			uint32_t kind;
+			double time;
+		};
+
+		//route weights from the source to every vertex, or from every vertex to it along the incoming edges
+		std::vector<double> ComputeDistances(const ::graph::CsrGraph<double>& graph
+			, const std::vector<std::vector<::graph::EdgeId>>* incoming_edges, size_t source)
+		{
+			using QueueItem = std::pair<double, size_t>;
+
+			std::vector<double> distances(graph.GetVertexCount(), std::numeric_limits<double>::infinity());
+			std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+			distances[source] = 0.;
+			queue.push({ 0., source });
+			while (!queue.empty()) {
+				const auto [distance, vertex] = queue.top();
+				queue.pop();
+				if (distance > distances[vertex]) {
+					continue;
+				}
+				auto relax = [&distances, &queue, distance](size_t next_vertex, double weight) {
+					if (distance + weight < distances[next_vertex]) {
+						distances[next_vertex] = distance + weight;
+						queue.push({ distances[next_vertex], next_vertex });
+					}
+				};
+				if (incoming_edges) {
+					for (const ::graph::EdgeId edge_id : (*incoming_edges)[vertex]) {
+						relax(graph.GetEdge(edge_id).from, graph.GetEdge(edge_id).weight);
+					}
+				}
+				else {
+					for (const auto& arc : graph.GetArcs(vertex)) {
+						relax(arc.to, arc.weight);
+					}
+				}
+			}
+
+			return distances;
+		}
+	}
+
+	void TransportRouter::Init(TransportRouterInitList&& init) {
+		bus_velocity_ = init.bus_velocity;
+		bus_wait_time_ = init.bus_wait_time;
+		engine_ = init.engine;
+		threads_count_ = init.threads_count;
+		graph_model_ = init.graph_model;
+		route_cache_bytes_ = init.route_cache_bytes;
+		catalogue_ = init.catalogue;
+		pool_uptr_ = std::make_unique<thread_pool::ThreadPool>(threads_count_);
+		routes_cache_uptr_ = std::make_unique<RoutesCache>(route_cache_bytes_);
+
+		if (!init.cache_file.empty() && LoadCache(init.cache_file, init.source_checksum)) {
+			return;
+		}
+
+		graph_ = ::graph::DirectedWeightedGraph<double>{ catalogue_->GetStopsCount() };
+		SetGraphWithRoutes();
+		csr_graph_ = ::graph::CsrGraph<double>{ graph_ };
+		router_uptr_ = CreateRouter();
+
+		if (!init.cache_file.empty()) {
+			SaveCache(init.cache_file, init.source_checksum);
+		}
+	}
+
+	void TransportRouter::InitCopy(const TransportRouter& other, const Catalogue* catalogue) {
+		bus_velocity_ = other.bus_velocity_;
+		bus_wait_time_ = other.bus_wait_time_;
+		engine_ = other.engine_;
+		threads_count_ = other.threads_count_;
+		graph_model_ = other.graph_model_;
+		route_cache_bytes_ = other.route_cache_bytes_;
+		catalogue_ = catalogue;
+		pool_uptr_ = std::make_unique<thread_pool::ThreadPool>(threads_count_);
+		routes_cache_uptr_ = std::make_unique<RoutesCache>(route_cache_bytes_);
+
+		router_uptr_.reset();
+		cache_mapping_.reset();
+		graph_ = other.graph_;
+		csr_graph_ = other.csr_graph_;
+		wrapper_uptr_ = std::make_unique<Wrapper>(*other.wrapper_uptr_);
+		//the table of the other router can be in its mapped cache file, the copy owns it
+		router_uptr_ = other.router_uptr_->Clone(csr_graph_);
+
+		//the items refer to the names of the other catalogue, so they are made again of the edges
+		//, a missing route refers to nothing and is shared
+		other.routes_cache_uptr_->ForEach([this](const std::pair<size_t, size_t>& vertices, const CachedRoutePtr& cached_route) {
+			SaveRouteInfo(vertices.first, vertices.second, cached_route->info
+				? CreateCachedRoute(::graph::IRouter<double>::RouteInfo{
+					.weight = cached_route->info->total_time, .edges = cached_route->edges })
+				: cached_route);
+		});
+	}
+
+	RouteInfoPtr TransportRouter::GetRouteInfo(std::string_view from, std::string_view to) const {
+		std::optional<size_t> vertex_from{ WrapStop(from) };
+		std::optional<size_t> vertex_to{ WrapStop(to) };
+
+		if (!vertex_from || !vertex_to) {
+			return nullptr;
+		}
+
+		if (CachedRoutePtr cached_route = routes_cache_uptr_->Get({ vertex_from.value(), vertex_to.value() })) {
+			return ShareRouteInfo(cached_route);
+		}
+
+		return CreateAndSaveNewRouteInfo(vertex_from.value(), vertex_to.value());
+	}
+
+	std::vector<RouteInfoPtr> TransportRouter::GetRoutesInfo(const std::vector<RouteRequest>& requests) const {
+		using RawRouteInfo = ::graph::IRouter<double>::RouteInfo;
+
+		//the answers hold their routes, so an eviction from the cache during the batch loses nothing
+		std::vector<RouteInfoPtr> routes_info(requests.size());
+		//indices of the requests waiting for every route to build
+		std::unordered_map<std::pair<size_t, size_t>, std::vector<size_t>, SizeTPairHasher> pending_requests;
+		std::unordered_map<size_t, std::vector<size_t>> targets_by_source;
+		for (size_t index = 0; index < requests.size(); ++index) {
+			std::optional<size_t> vertex_from{ WrapStop(requests[index].first) };
+			std::optional<size_t> vertex_to{ WrapStop(requests[index].second) };
+			if (!vertex_from || !vertex_to) {
+				continue;
+			}
+
+			const std::pair<size_t, size_t> vertices{ vertex_from.value(), vertex_to.value() };
+			if (auto it = pending_requests.find(vertices); it != pending_requests.end()) {
+				it->second.push_back(index);
+				continue;
+			}
+			if (CachedRoutePtr cached_route = routes_cache_uptr_->Get(vertices)) {
+				routes_info[index] = ShareRouteInfo(cached_route);
+				continue;
+			}
+			pending_requests[vertices].push_back(index);
+			targets_by_source[vertex_from.value()].push_back(vertex_to.value());
+		}
+
+		std::vector<std::pair<size_t, std::vector<size_t>>> sources{ targets_by_source.begin(), targets_by_source.end() };
+		std::vector<std::vector<CachedRoutePtr>> sources_routes(sources.size());
+		pool_uptr_->ParallelFor(sources.size(), [this, &sources, &sources_routes](size_t index) {
+			const auto& [from, targets] = sources[index];
+			for (std::optional<RawRouteInfo>& raw_info : router_uptr_->BuildRoutes(from, targets)) {
+				sources_routes[index].push_back(CreateCachedRoute(std::move(raw_info)));
+			}
+		});
+
+		for (size_t index = 0; index < sources.size(); ++index) {
+			const auto& [from, targets] = sources[index];
+			for (size_t target_index = 0; target_index < targets.size(); ++target_index) {
+				const CachedRoutePtr& cached_route = sources_routes[index][target_index];
+				SaveRouteInfo(from, targets[target_index], cached_route);
+				for (const size_t request_index : pending_requests.at({ from, targets[target_index] })) {
+					routes_info[request_index] = ShareRouteInfo(cached_route);
+				}
+			}
+		}
+
+		return routes_info;
+	}
+
+	std::vector<ReachableStop> TransportRouter::GetReachableStops(std::string_view from, double max_time) const {
+		using QueueItem = std::pair<double, size_t>;
+
+		const auto stop_from{ catalogue_->FindStopId(from) };
+		if (!stop_from) {
+			return {};
+		}
+		std::optional<size_t> vertex_from{ wrapper_uptr_->WrapVertex(stop_from.value()) };
+		if (!vertex_from) {
+			return { ReachableStop{ .stop_name = catalogue_->GetStopName(stop_from.value()), .time = 0. } };
+		}
+
+		std::vector<ReachableStop> reachable_stops;
+		//a stop can have more vertices than one (the ride vertices of the transfers model)
+		//, the first of them settled gives its time
+		std::unordered_set<::transport_catalogue::details::StopId> reached_stops;
+		std::unordered_map<size_t, double> times{ { vertex_from.value(), 0. } };
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+		queue.push({ 0., vertex_from.value() });
+		while (!queue.empty()) {
+			const auto [time, vertex] = queue.top();
+			queue.pop();
+			if (time > times.at(vertex)) {
+				continue;
+			}
+			if (const auto stop{ wrapper_uptr_->UnwrapVertex(vertex) }; stop && reached_stops.insert(stop.value()).second) {
+				reachable_stops.push_back(ReachableStop{ .stop_name = catalogue_->GetStopName(stop.value()), .time = time });
+			}
+
+			for (const auto& arc : csr_graph_.GetArcs(vertex)) {
+				const double arc_time{ time + arc.weight };
+				if (arc_time > max_time) {
+					continue;
+				}
+				auto [it, inserted] = times.emplace(arc.to, arc_time);
+				if (inserted || arc_time < it->second) {
+					it->second = arc_time;
+					queue.push({ arc_time, arc.to });
+				}
+			}
+		}
+
+		std::sort(reachable_stops.begin(), reachable_stops.end(), [](const ReachableStop& lhs, const ReachableStop& rhs) {
+			return lhs.time < rhs.time || (lhs.time == rhs.time && lhs.stop_name < rhs.stop_name);
+		});
+		return reachable_stops;
+	}
+
+	TravelMatrix TransportRouter::GetTravelMatrix(const std::vector<std::string_view>& from
+		, const std::vector<std::string_view>& to, bool with_routes) const
+	{
+		//the stops are searched by their distinct vertices, the matrix cells refer to them
+		auto wrap_stops = [this](const std::vector<std::string_view>& names, std::vector<size_t>& vertices) {
+			std::unordered_map<size_t, size_t> vertex_indices;
+			std::vector<std::optional<size_t>> indices;
+			for (const std::string_view name : names) {
+				std::optional<size_t> vertex{ WrapStop(name) };
+				if (!vertex) {
+					indices.push_back(std::nullopt);
+					continue;
+				}
+				auto [it, inserted] = vertex_indices.emplace(vertex.value(), vertices.size());
+				if (inserted) {
+					vertices.push_back(vertex.value());
+				}
+				indices.push_back(it->second);
+			}
+			return indices;
+		};
+		std::vector<size_t> sources;
+		std::vector<size_t> targets;
+		const std::vector<std::optional<size_t>> rows{ wrap_stops(from, sources) };
+		const std::vector<std::optional<size_t>> columns{ wrap_stops(to, targets) };
+
+		std::vector<std::vector<std::optional<double>>> sources_times(sources.size());
+		std::vector<std::vector<RouteInfoPtr>> sources_routes(sources.size());
+		if (!targets.empty()) {
+			pool_uptr_->ParallelFor(sources.size(), [&](size_t index) {
+				//the times alone don't need the edges of the routes
+				if (!with_routes) {
+					sources_times[index] = router_uptr_->BuildWeights(sources[index], targets);
+					return;
+				}
+				for (const auto& raw_info : router_uptr_->BuildRoutes(sources[index], targets)) {
+					sources_times[index].push_back(raw_info
+						? std::optional<double>{ raw_info->weight }
+						: std::nullopt);
+					sources_routes[index].push_back(raw_info
+						? std::make_shared<const RouteInfo>(CreateRouteInfo(raw_info.value()))
+						: nullptr);
+				}
+			});
+		}
+
+		TravelMatrix matrix;
+		for (const std::optional<size_t> row : rows) {
+			auto& times_row{ matrix.times.emplace_back() };
+			auto* routes_row{ with_routes ? &matrix.routes.emplace_back() : nullptr };
+			for (const std::optional<size_t> column : columns) {
+				const bool has_route{ row && column };
+				times_row.push_back(has_route ? sources_times[*row][*column] : std::nullopt);
+				if (routes_row) {
+					routes_row->push_back(has_route ? sources_routes[*row][*column] : nullptr);
+				}
+			}
+		}
+
+		return matrix;
+	}
+
+	::graph::IRouter<double>::SearchStats TransportRouter::GetSearchStats() const {
+		return router_uptr_->GetSearchStats();
+	}
+
+	lru_cache::CacheStats TransportRouter::GetRouteCacheStats() const {
+		return routes_cache_uptr_->GetStats();
+	}
+
+	std::optional<size_t> TransportRouter::WrapStop(std::string_view name) const {
+		//an unknown name is rejected by the names index, no exception is thrown for it
+		const std::optional<::transport_catalogue::details::StopId> stop{ catalogue_->FindStopId(name) };
+		return stop ? wrapper_uptr_->WrapVertex(stop.value()) : std::nullopt;
+	}
+
+	RouteInfoPtr TransportRouter::CreateAndSaveNewRouteInfo(size_t from, size_t to) const {
+		CachedRoutePtr cached_route{ CreateCachedRoute(router_uptr_->BuildRoute(from, to)) };
+		SaveRouteInfo(from, to, cached_route);
+
+		return ShareRouteInfo(cached_route);
+	}
+
+	TransportRouter::CachedRoutePtr TransportRouter::CreateCachedRoute(std::optional<::graph::IRouter<double>::RouteInfo>&& raw_info) const {
+		if (!raw_info) {
+			return std::make_shared<const CachedRoute>(CachedRoute{ .info = std::nullopt, .edges = {} });
+		}
+		RouteInfo route_info{ CreateRouteInfo(raw_info.value()) };
+		return std::make_shared<const CachedRoute>(CachedRoute{ .info = std::move(route_info), .edges = std::move(raw_info->edges) });
+	}
+
+	void TransportRouter::SaveRouteInfo(size_t from, size_t to, const CachedRoutePtr& cached_route) const {
+		//the shared_ptr control block is allocated together with the route by make_shared
+		const size_t bytes{ sizeof(CachedRoute) + 2 * sizeof(void*)
+			+ (cached_route->info ? cached_route->info->items.capacity() : 0) * sizeof(Item)
+			+ cached_route->edges.capacity() * sizeof(::graph::EdgeId)
+		};
+		routes_cache_uptr_->Put({ from, to }, cached_route, bytes);
+	}
+
+	RouteInfoPtr TransportRouter::ShareRouteInfo(const CachedRoutePtr& cached_route) {
+		//the route info shares the ownership of the whole cached route
+		return cached_route && cached_route->info ? RouteInfoPtr{ cached_route, &cached_route->info.value() } : nullptr;
+	}
+
+	RouteInfo TransportRouter::CreateRouteInfo(const ::graph::IRouter<double>::RouteInfo& raw_info) const {
+		using EdgeKind = Wrapper::EdgeKind;
+
+		std::vector<Item> items;
+		for (const auto edge_id : raw_info.edges) {
+			const auto& item_info = wrapper_uptr_->UnwrapEdge(edge_id);
+			switch (item_info.kind) {
+			case EdgeKind::SubRoute:
+			case EdgeKind::Board:
+			{
+				WaitItem wait_item{ .stop_name = catalogue_->GetStopName(item_info.wait_stop), .time = bus_wait_time_ };
+				items.push_back({ std::move(wait_item) });
+				BusItem bus_item{ .bus = catalogue_->GetRouteName(item_info.bus), .span_count = item_info.span_count, .time = item_info.time };
+				items.push_back({ std::move(bus_item) });
+				break;
+			}
+			case EdgeKind::Ride:
+			{
+				//consecutive rides are collapsed into the bus item opened by the boarding
+				BusItem& bus_item = std::get<BusItem>(items.back().content);
+				bus_item.span_count += item_info.span_count;
+				bus_item.time += item_info.time;
+				break;
+			}
+			case EdgeKind::Alight:
+				break;
+			}
+		}
+
+		return RouteInfo{ .total_time = raw_info.weight, .items = std::move(items) };
+	}
+
+	void TransportRouter::SetGraphWithRoutes() {
+		auto builder = Wrapper::Builder<Catalogue, Wrapper>{
+			{
+				.catalogue = *catalogue_,
+				.graph = graph_,
+				.bus_wait_time = bus_wait_time_,
+				.bus_velocity = bus_velocity_,
+				.model = graph_model_
+			}
+		};
+		wrapper_uptr_ = builder.Make();
+	}
+
+	bool TransportRouter::IsInitialized() const {
+		return router_uptr_ != nullptr;
+	}
+
+	void TransportRouter::UpdateRoutes(const std::vector<::transport_catalogue::details::RouteId>& routes) {
+		std::vector<::graph::EdgeId> increased_edges;
+		std::vector<::graph::EdgeId> decreased_edges;
+		for (const auto route : routes) {
+			const std::vector<size_t>& route_edges{ wrapper_uptr_->GetRouteEdges(route) };
+			const size_t stops_count{ catalogue_->GetRouteStops(route).size() };
+
+			//the edges are made again by a builder of their own, in the same order as the first time
+			::graph::DirectedWeightedGraph<double> graph{ 2 * stops_count };
+			auto builder{ CreateContinuedBuilder(graph, nullptr, 0, 0) };
+			builder.AddRoute(route);
+			const auto route_wrapper{ builder.Release() };
+			if (graph.GetEdgeCount() != route_edges.size()) {
+				throw std::logic_error{ "TransportRouter::UpdateRoutes: The route doesn't match its edges!" };
+			}
+
+			for (size_t index = 0; index < route_edges.size(); ++index) {
+				const double weight{ graph.GetEdge(index).weight };
+				const double old_weight{ csr_graph_.GetEdge(route_edges[index]).weight };
+				if (weight == old_weight) {
+					continue;
+				}
+				(weight > old_weight ? increased_edges : decreased_edges).push_back(route_edges[index]);
+				csr_graph_.SetEdgeWeight(route_edges[index], weight);
+				wrapper_uptr_->SetEdgeTime(route_edges[index], route_wrapper->UnwrapEdge(index).time);
+			}
+		}
+
+		if (!increased_edges.empty() || !decreased_edges.empty()) {
+			ApplyEdgesUpdate(increased_edges, decreased_edges);
+		}
+	}
+
+	void TransportRouter::AddRoute(::transport_catalogue::details::RouteId route) {
+		const size_t stops_count{ catalogue_->GetRouteStops(route).size() };
+		const size_t vertex_count{ csr_graph_.GetVertexCount() };
+		const size_t edge_count{ csr_graph_.GetEdgeCount() };
+
+		//a dry run first: the wrapper is handed to the builder, so it mustn't throw on a missing distance
+		{
+			::graph::DirectedWeightedGraph<double> graph{ 2 * stops_count };
+			CreateContinuedBuilder(graph, nullptr, 0, 0).AddRoute(route);
+		}
+
+		::graph::DirectedWeightedGraph<double> graph{ vertex_count + 2 * stops_count };
+		auto builder{ CreateContinuedBuilder(graph, std::move(wrapper_uptr_), vertex_count, edge_count) };
+		builder.AddRoute(route);
+		wrapper_uptr_ = builder.Release();
+
+		std::vector<::graph::Edge<double>> new_edges;
+		std::vector<::graph::EdgeId> new_edges_ids;
+		for (size_t edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+			new_edges.push_back(graph.GetEdge(edge_id));
+			new_edges_ids.push_back(edge_count + edge_id);
+		}
+		csr_graph_.AddEdges(new_edges, builder.GetVertexCount());
+
+		ApplyEdgesUpdate({}, new_edges_ids);
+	}
+
+	void TransportRouter::RemoveRoute(::transport_catalogue::details::RouteId route) {
+		const std::vector<size_t> removed_edges{ wrapper_uptr_->RemoveRouteEdges(route) };
+		if (removed_edges.empty()) {
+			return;
+		}
+
+		csr_graph_.RemoveEdges(removed_edges);
+		ApplyEdgesUpdate(removed_edges, {});
+	}
+
+	void TransportRouter::UpdateStopLocation(::transport_catalogue::details::StopId stop) {
+		if (engine_ != RouterEngine::AStar || !wrapper_uptr_->WrapVertex(stop)) {
+			return;
+		}
+		//the cached routes stay: the edges weights are the same
+		router_uptr_.reset();
+		router_uptr_ = CreateRouter();
+	}
+
+	TransportRouter::Wrapper::Builder<TransportRouter::Catalogue, TransportRouter::Wrapper> TransportRouter::CreateContinuedBuilder(
+		::graph::DirectedWeightedGraph<double>& graph, std::unique_ptr<Wrapper>&& wrapper
+		, size_t vertex_count, size_t edge_count) const
+	{
+		return Wrapper::Builder<Catalogue, Wrapper>{
+			{
+				.catalogue = *catalogue_,
+				.graph = graph,
+				.bus_wait_time = bus_wait_time_,
+				.bus_velocity = bus_velocity_,
+				.model = graph_model_
+			}
+			, std::move(wrapper), vertex_count, edge_count
+		};
+	}
+
+	void TransportRouter::ApplyEdgesUpdate(const std::vector<::graph::EdgeId>& increased_edges
+		, const std::vector<::graph::EdgeId>& decreased_edges)
+	{
+		//an engine patches what it can (e.g. Floyd-Warshall recomputes only the rows going through the heavier edges),
+		//otherwise it's created again for the whole graph
+		if (!router_uptr_->UpdateEdges(increased_edges, decreased_edges)) {
+			router_uptr_.reset();
+			router_uptr_ = CreateRouter();
+			cache_mapping_.reset();
+		}
+		InvalidateCachedRoutes(increased_edges, decreased_edges);
+	}
+
+	void TransportRouter::InvalidateCachedRoutes(const std::vector<::graph::EdgeId>& increased_edges
+		, const std::vector<::graph::EdgeId>& decreased_edges)
+	{
+		//each lighter edge takes two searches, the whole cache is dropped for larger updates
+		constexpr size_t MAX_DISTANCES_SEARCHES{ 64 };
+
+		std::unordered_map<size_t, std::vector<double>> distances_to;
+		std::unordered_map<size_t, std::vector<double>> distances_from;
+		for (const ::graph::EdgeId edge_id : decreased_edges) {
+			distances_to[csr_graph_.GetEdge(edge_id).from];
+			distances_from[csr_graph_.GetEdge(edge_id).to];
+		}
+		if (distances_to.size() + distances_from.size() > MAX_DISTANCES_SEARCHES) {
+			routes_cache_uptr_->Clear();
+			return;
+		}
+
+		std::vector<std::vector<::graph::EdgeId>> incoming_edges;
+		if (!distances_to.empty()) {
+			incoming_edges.resize(csr_graph_.GetVertexCount());
+			for (const auto& arc : csr_graph_.GetArcsArray()) {
+				incoming_edges[arc.to].push_back(arc.edge_id);
+			}
+		}
+		for (auto& [vertex, distances] : distances_to) {
+			distances = ComputeDistances(csr_graph_, &incoming_edges, vertex);
+		}
+		for (auto& [vertex, distances] : distances_from) {
+			distances = ComputeDistances(csr_graph_, nullptr, vertex);
+		}
+
+		const std::unordered_set<::graph::EdgeId> increased_edges_set{ increased_edges.begin(), increased_edges.end() };
+		routes_cache_uptr_->EraseIf([&](const std::pair<size_t, size_t>& vertices, const CachedRoute& cached_route) {
+			//a route made of a heavier edge can get longer
+			for (const ::graph::EdgeId edge_id : cached_route.edges) {
+				if (increased_edges_set.contains(edge_id)) {
+					return true;
+				}
+			}
+			//a lighter edge (u, v) shortens the route from s to t if the way s -> u -> v -> t is shorter
+			//, a missing route appears if there is such a way at all
+			const double total_time{ cached_route.info
+				? cached_route.info->total_time
+				: std::numeric_limits<double>::infinity() };
+			for (const ::graph::EdgeId edge_id : decreased_edges) {
+				const auto& edge{ csr_graph_.GetEdge(edge_id) };
+				const double weight_through{ distances_to.at(edge.from)[vertices.first] + edge.weight
+					+ distances_from.at(edge.to)[vertices.second] };
+				if (weight_through + 1e-9 < total_time) {
+					return true;
+				}
+			}
+			return false;
+		});
+	}
+
+	std::unique_ptr<::graph::IRouter<double>> TransportRouter::CreateRouter() const {
+		switch (engine_) {
+		case RouterEngine::FloydWarshall:
+			return std::make_unique<::graph::Router<double>>(csr_graph_, threads_count_);
+		case RouterEngine::Dijkstra:
+			return std::make_unique<::graph::DijkstraRouter<double>>(csr_graph_);
+		case RouterEngine::ContractionHierarchies:
+			return std::make_unique<::graph::ContractionHierarchiesRouter<double>>(csr_graph_);
+		case RouterEngine::AStar:
+			return std::make_unique<::graph::AStarRouter<double>>(csr_graph_, CreateGeoHeuristic());
+		default:
+			throw std::logic_error{ "TransportRouter::CreateRouter: Unknown router engine!" };
+		}
+	}
+
+	::graph::AStarRouter<double>::Heuristic TransportRouter::CreateGeoHeuristic() const {
+		std::vector<std::optional<geo::Coordinates>> locations(csr_graph_.GetVertexCount());
+		for (size_t vertex = 0; vertex < csr_graph_.GetVertexCount(); ++vertex) {
+			if (const auto stop = wrapper_uptr_->UnwrapVertex(vertex)) {
+				locations[vertex] = catalogue_->GetStopLocation(stop.value());
+			}
+		}
+
+		auto compute_ride_time = [velocity = bus_velocity_](geo::Coordinates from, geo::Coordinates to) {
+			const double distance{ from == to ? 0. : geo::ComputeDistance(from, to) };
+			return std::isfinite(distance)
+				? distance / 1000. / static_cast<double>(velocity) * 60.	// m -> min
+				: 0.;
+		};
+
+		//road distances can be shorter than the geographical ones, so the ride time along the straight line
+		//is scaled with the least ratio of an edge weight to it. That keeps the bound consistent for every edge
+		double scale{ std::numeric_limits<double>::infinity() };
+		for (size_t edge_id = 0; edge_id < csr_graph_.GetEdgeCount(); ++edge_id) {
+			const auto& edge = csr_graph_.GetEdge(edge_id);
+			if (!locations[edge.from] || !locations[edge.to]) {
+				continue;
+			}
+			if (const double straight_time = compute_ride_time(*locations[edge.from], *locations[edge.to]); straight_time > 0.) {
+				scale = std::min(scale, edge.weight / straight_time);
+			}
+		}
+		if (!std::isfinite(scale)) {
+			scale = 0.;
+		}
+
+		return [locations = std::move(locations), scale, compute_ride_time](size_t from, size_t to) -> double {
+			if (!locations[from] || !locations[to]) {
+				return 0.;
+			}
+			return scale * compute_ride_time(*locations[from], *locations[to]);
+		};
+	}
+
+	bool TransportRouter::LoadCache(const std::string& path, uint64_t source_checksum) {
+		using EdgeKind = Wrapper::EdgeKind;
+
+		std::optional<mapped_file::MappedFile> mapping{ mapped_file::MappedFile::Open(path) };
+		if (!mapping) {
+			return false;
+		}
+
+		mapped_file::ArraysReader reader{ mapping->GetData(), mapping->GetSize() };
+		const auto header_span{ reader.Read<CacheHeader>(1) };
+		if (!header_span) {
+			return false;
+		}
+		const CacheHeader& header{ header_span->front() };
+		const bool has_routes_table{ engine_ == RouterEngine::FloydWarshall };
+		const bool has_hierarchy{ engine_ == RouterEngine::ContractionHierarchies };
+		if (header.magic != CACHE_MAGIC
+			|| header.version != CACHE_VERSION
+			|| header.layout != CACHE_LAYOUT
+			|| header.source_checksum != source_checksum
+			|| header.engine != static_cast<uint32_t>(engine_)
+			|| header.graph_model != static_cast<uint32_t>(graph_model_)
+			|| header.bus_wait_time != bus_wait_time_
+			|| header.bus_velocity != bus_velocity_
+			|| header.has_routes_table != static_cast<uint64_t>(has_routes_table)
+			|| (!has_hierarchy && header.hierarchy_edge_count != 0)
+			|| header.vertex_count >= std::numeric_limits<uint32_t>::max()
+			|| header.edge_count >= std::numeric_limits<uint32_t>::max()
+			|| header.names_count >= NO_NAME)
+		{
+			return false;
+		}
+		const size_t vertex_count{ static_cast<size_t>(header.vertex_count) };
+		const size_t edge_count{ static_cast<size_t>(header.edge_count) };
+
+		const auto names_offsets{ reader.Read<uint64_t>(header.names_count + 1) };
+		const auto names_chars{ reader.Read<char>(header.names_size) };
+		const auto vertices{ reader.Read<VertexRecord>(vertex_count) };
+		const auto offsets{ reader.Read<size_t>(vertex_count + 1) };
+		const auto arcs{ reader.Read<Arc>(edge_count) };
+		const auto edges{ reader.Read<Edge>(edge_count) };
+		const auto edges_info{ reader.Read<EdgeRecord>(edge_count) };
+		if (!names_offsets || !names_chars || !vertices || !offsets || !arcs || !edges || !edges_info) {
+			return false;
+		}
+		std::optional<std::span<const FloydWarshallRouter::PackedWeight>> table_weights;
+		std::optional<std::span<const FloydWarshallRouter::PackedEdgeId>> table_prev_edges;
+		if (has_routes_table) {
+			table_weights = reader.Read<FloydWarshallRouter::PackedWeight>(vertex_count * vertex_count);
+			table_prev_edges = reader.Read<FloydWarshallRouter::PackedEdgeId>(vertex_count * vertex_count);
+			if (!table_weights || !table_prev_edges) {
+				return false;
+			}
+		}
+		std::optional<std::span<const ContractionHierarchiesRouter::PackedEdge>> hierarchy_edges;
+		std::optional<std::span<const ContractionHierarchiesRouter::PackedId>> hierarchy_ranks;
+		if (has_hierarchy) {
+			hierarchy_edges = reader.Read<ContractionHierarchiesRouter::PackedEdge>(header.hierarchy_edge_count);
+			hierarchy_ranks = reader.Read<ContractionHierarchiesRouter::PackedId>(vertex_count);
+			if (!hierarchy_edges || !hierarchy_ranks) {
+				return false;
+			}
+		}
+
+		//the graph and the routes table are checked, so a broken file can't send a query out of the arrays
+		if (offsets->front() != 0 || offsets->back() != edge_count
+			|| !std::is_sorted(offsets->begin(), offsets->end()))
+		{
+			return false;
+		}
+		for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+			for (size_t arc_id = (*offsets)[vertex]; arc_id < (*offsets)[vertex + 1]; ++arc_id) {
+				const Arc& arc{ (*arcs)[arc_id] };
+				if (arc.to >= vertex_count || arc.edge_id >= edge_count || (*edges)[arc.edge_id].from != vertex) {
+					return false;
+				}
+			}
+		}
+		for (const Edge& edge : *edges) {
+			if (edge.from >= vertex_count || edge.to >= vertex_count) {
+				return false;
+			}
+		}
+		::graph::CsrGraph<double> csr_graph{ *offsets, *arcs, *edges };
+		if (has_routes_table && !FloydWarshallRouter::IsValidRoutesTable(csr_graph
+			, FloydWarshallRouter::RoutesTable{ .weights = *table_weights, .prev_edges = *table_prev_edges }))
+		{
+			return false;
+		}
+		if (has_hierarchy && !ContractionHierarchiesRouter::IsValidHierarchy(csr_graph
+			, ContractionHierarchiesRouter::Hierarchy{ .edges = *hierarchy_edges, .ranks = *hierarchy_ranks }))
+		{
+			return false;
+		}
+
+		//names are resolved to the catalogue strings, a name unknown to the catalogue means a stale file
+		auto get_name = [&](uint32_t name_id) -> std::optional<std::string_view> {
+			if (name_id >= header.names_count) {
+				return std::nullopt;
+			}
+			const uint64_t begin{ (*names_offsets)[name_id] };
+			const uint64_t end{ (*names_offsets)[name_id + 1] };
+			if (begin > end || end > names_chars->size()) {
+				return std::nullopt;
+			}
+			return std::string_view{ names_chars->data() + begin, static_cast<size_t>(end - begin) };
+		};
+
+		Wrapper::Restorer restorer{};
+		try {
+			for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+				const VertexRecord& record{ (*vertices)[vertex] };
+				if (record.name == NO_NAME) {
+					continue;
+				}
+				const auto name{ get_name(record.name) };
+				if (!name) {
+					return false;
+				}
+				if (record.is_stop) {
+					restorer.AddStopVertex(vertex, catalogue_->GetStopId(*name));
+				}
+				else {
+					restorer.AddRideVertex(vertex, catalogue_->GetStopId(*name));
+				}
+			}
+			for (size_t edge_id = 0; edge_id < edge_count; ++edge_id) {
+				const EdgeRecord& record{ (*edges_info)[edge_id] };
+				const auto bus_name{ get_name(record.bus_name) };
+				const auto wait_stop_name{ get_name(record.wait_stop_name) };
+				if (!bus_name || !wait_stop_name || record.kind > static_cast<uint32_t>(EdgeKind::Alight)) {
+					return false;
+				}
+				restorer.AddEdge(edge_id, Wrapper::EdgeInfo{
+						.bus = catalogue_->GetRouteId(*bus_name),
+						.wait_stop = catalogue_->GetStopId(*wait_stop_name),
+						.span_count = record.span_count,
+						.time = record.time,
+						.kind = static_cast<EdgeKind>(record.kind)
+					}
+				);
+			}
+		}
+		catch (const std::logic_error&) {
+			return false;
+		}
+
+		router_uptr_.reset();
+		graph_ = ::graph::DirectedWeightedGraph<double>{};
+		csr_graph_ = std::move(csr_graph);
+		wrapper_uptr_ = restorer.Make();
+		if (has_routes_table) {
+			//the table is used right from the mapped file
+			router_uptr_ = std::make_unique<FloydWarshallRouter>(csr_graph_
+				, FloydWarshallRouter::RoutesTable{ .weights = *table_weights, .prev_edges = *table_prev_edges });
+			cache_mapping_ = std::move(mapping);
+		}
+		else if (has_hierarchy) {
+			//the hierarchy is copied, the search graphs of it are built again
+			router_uptr_ = std::make_unique<ContractionHierarchiesRouter>(csr_graph_
+				, ContractionHierarchiesRouter::Hierarchy{ .edges = *hierarchy_edges, .ranks = *hierarchy_ranks });
+		}
+		else {
+			router_uptr_ = CreateRouter();
+		}
+
+		return true;
+	}
+
+	void TransportRouter::SaveCache(const std::string& path, uint64_t source_checksum) const {
+		const size_t vertex_count{ csr_graph_.GetVertexCount() };
+		const size_t edge_count{ csr_graph_.GetEdgeCount() };
+
+		std::vector<std::string_view> names;
+		std::unordered_map<std::string_view, uint32_t> names_ids;
+		auto give_name_id = [&names, &names_ids](std::string_view name) {
+			auto [it, inserted] = names_ids.insert({ name, static_cast<uint32_t>(names.size()) });
+			if (inserted) {
+				names.push_back(name);
+			}
+			return it->second;
+		};
+
+		std::vector<VertexRecord> vertices(vertex_count, VertexRecord{ .name = NO_NAME, .is_stop = 0 });
+		for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+			if (const auto stop = wrapper_uptr_->UnwrapVertex(vertex)) {
+				vertices[vertex].name = give_name_id(catalogue_->GetStopName(stop.value()));
+				vertices[vertex].is_stop = wrapper_uptr_->IsStopVertex(vertex);
+			}
+		}
+
+		std::vector<EdgeRecord> edges_info;
+		edges_info.reserve(edge_count);
+		for (size_t edge_id = 0; edge_id < edge_count; ++edge_id) {
+			const auto& edge_info{ wrapper_uptr_->UnwrapEdge(edge_id) };
+			edges_info.push_back(EdgeRecord{
+					.bus_name = give_name_id(catalogue_->GetRouteName(edge_info.bus)),
+					.wait_stop_name = give_name_id(catalogue_->GetStopName(edge_info.wait_stop)),
+					.span_count = edge_info.span_count,
+					.kind = static_cast<uint32_t>(edge_info.kind),
+					.time = edge_info.time
+				}
+			);
+		}
+
+		std::vector<uint64_t> names_offsets{ 0 };
+		std::string names_chars;
+		for (std::string_view name : names) {
+			names_chars += name;
+			names_offsets.push_back(names_chars.size());
+		}
+
+		const auto* floyd_warshall_router{ dynamic_cast<const FloydWarshallRouter*>(router_uptr_.get()) };
+		const auto* contraction_hierarchies_router{ dynamic_cast<const ContractionHierarchiesRouter*>(router_uptr_.get()) };
+		std::vector<ContractionHierarchiesRouter::PackedEdge> hierarchy_edges;
+		std::vector<ContractionHierarchiesRouter::PackedId> hierarchy_ranks;
+		if (contraction_hierarchies_router) {
+			hierarchy_edges = contraction_hierarchies_router->GetPackedEdges();
+			hierarchy_ranks = contraction_hierarchies_router->GetPackedRanks();
+		}
+
+		const CacheHeader header{
+			.magic = CACHE_MAGIC,
+			.version = CACHE_VERSION,
+			.layout = CACHE_LAYOUT,
+			.source_checksum = source_checksum,
+			.engine = static_cast<uint32_t>(engine_),
+			.graph_model = static_cast<uint32_t>(graph_model_),
+			.bus_wait_time = bus_wait_time_,
+			.bus_velocity = bus_velocity_,
+			.vertex_count = vertex_count,
+			.edge_count = edge_count,
+			.names_count = names.size(),
+			.names_size = names_chars.size(),
+			.has_routes_table = floyd_warshall_router != nullptr,
+			.hierarchy_edge_count = hierarchy_edges.size()
+		};
+
+		//the file is written aside and renamed, so a process starting meanwhile never maps a partial one
+		const std::string temp_path{ path + ".tmp" };
+		{
+			std::ofstream output{ temp_path, std::ios::binary | std::ios::trunc };
+			mapped_file::ArraysWriter writer{ output };
+			writer.Write(header);
+			writer.Write(std::span<const uint64_t>{ names_offsets });
+			writer.Write(std::span<const char>{ names_chars });
+			writer.Write(std::span<const VertexRecord>{ vertices });
+			writer.Write(csr_graph_.GetOffsets());
+			writer.Write(csr_graph_.GetArcsArray());
+			writer.Write(csr_graph_.GetEdges());
+			writer.Write(std::span<const EdgeRecord>{ edges_info });
+			if (floyd_warshall_router) {
+				const auto table{ floyd_warshall_router->GetRoutesTable() };
+				writer.Write(table.weights);
+				writer.Write(table.prev_edges);
+			}
+			if (contraction_hierarchies_router) {
+				writer.Write(std::span<const ContractionHierarchiesRouter::PackedEdge>{ hierarchy_edges });
+				writer.Write(std::span<const ContractionHierarchiesRouter::PackedId>{ hierarchy_ranks });
+			}
+			if (!output.flush()) {
+				std::cerr << "TransportRouter::SaveCache: Can't write the router cache file " << temp_path << std::endl;
+				return;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_path, path, error);
+		if (error) {
+			std::cerr << "TransportRouter::SaveCache: Can't replace the router cache file " << path << ": " << error.message() << std::endl;
+		}
+	}
 }//transport_router
\ No newline at end of file
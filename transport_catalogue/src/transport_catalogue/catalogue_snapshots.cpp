@@ -0,0 +1,61 @@
+#include "catalogue_snapshots.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue
+{
+	CatalogueSnapshots::CatalogueSnapshots(Snapshot snapshot) {
+		Publish(std::move(snapshot));
+	}
+
+	CatalogueSnapshots::Snapshot CatalogueSnapshots::Pin() const {
+		return current_.load(std::memory_order_acquire);
+	}
+
+	void CatalogueSnapshots::Publish(Snapshot snapshot) {
+		if (!snapshot || !snapshot->IsFinalized()) {
+			throw std::logic_error{ "CatalogueSnapshots::Publish: The snapshot isn't finalized!" };
+		}
+
+		Snapshot replaced{ current_.exchange(std::move(snapshot), std::memory_order_acq_rel) };
+		{
+			std::lock_guard lock{ retired_mutex_ };
+			if (replaced) {
+				retired_.push_back(std::move(replaced));
+			}
+		}
+		Reclaim();
+	}
+
+	void CatalogueSnapshots::Update(const std::function<void(TransportCatalogue&)>& change) {
+		std::lock_guard lock{ update_mutex_ };
+		std::shared_ptr<TransportCatalogue> next;
+		{
+			//the pin is let go before the copy is published, so the replaced snapshot is reclaimed right away
+			//if no reader holds it
+			const Snapshot current{ Pin() };
+			if (!current) {
+				throw std::logic_error{ "CatalogueSnapshots::Update: No catalogue is published!" };
+			}
+			next = current->Clone();
+		}
+		change(*next);
+		next->Finalize();
+		Publish(std::move(next));
+	}
+
+	size_t CatalogueSnapshots::Reclaim() {
+		//a replaced snapshot can't be pinned again, so a snapshot held by the list only is free for good
+		std::vector<Snapshot> unpinned;
+		std::lock_guard lock{ retired_mutex_ };
+		auto pinned_end{ std::partition(retired_.begin(), retired_.end(), [](const Snapshot& snapshot) {
+			return snapshot.use_count() > 1;
+		}) };
+		std::move(pinned_end, retired_.end(), std::back_inserter(unpinned));
+		retired_.erase(pinned_end, retired_.end());
+		return retired_.size();
+	}
+}//transport_catalogue
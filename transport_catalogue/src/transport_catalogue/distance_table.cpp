@@ -0,0 +1,104 @@
+#include "distance_table.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace transport_catalogue
+{
+	DistanceTable::DistanceTable(std::span<const uint32_t> offsets, std::span<const Arc> arcs)
+		: offsets_{ mapped_file::MappedArray<uint32_t>::View(offsets) }
+		, arcs_{ mapped_file::MappedArray<Arc>::View(arcs) }
+	{
+	}
+
+	void DistanceTable::Set(StopId from, StopId to, Distance distance) {
+		//a distance already frozen is changed in place
+		if (const Arc* arc = FindArc(from, to)) {
+			const size_t index{ static_cast<size_t>(arc - arcs_.data()) };
+			arcs_.Mutable()[index].distance = distance;
+			return;
+		}
+		pending_entries_[{ from, to }] = distance;
+	}
+
+	std::optional<DistanceTable::Distance> DistanceTable::Find(StopId from, StopId to) const {
+		if (const auto distance = FindDirected(from, to)) {
+			return distance;
+		}
+		return FindDirected(to, from);
+	}
+
+	size_t DistanceTable::GetEntriesCount() const {
+		return arcs_.size() + pending_entries_.size();
+	}
+
+	void DistanceTable::Freeze() {
+		if (pending_entries_.empty()) {
+			return;
+		}
+
+		//the pending entries are new to the frozen rows: the set ones were changed in place
+		const size_t rows_count{ std::max<size_t>(offsets_.size() - 1, pending_entries_.rbegin()->first.first + size_t{ 1 }) };
+		std::vector<uint32_t> offsets(rows_count + 1, 0);
+		std::vector<Arc> arcs;
+		arcs.reserve(arcs_.size() + pending_entries_.size());
+		auto entry_it{ pending_entries_.begin() };
+		for (size_t from = 0; from < rows_count; ++from) {
+			auto arc_it{ from + 1 < offsets_.size() ? arcs_.begin() + offsets_[from] : arcs_.end() };
+			const auto arcs_end{ from + 1 < offsets_.size() ? arcs_.begin() + offsets_[from + 1] : arcs_.end() };
+			for (; entry_it != pending_entries_.end() && entry_it->first.first == from; ++entry_it) {
+				const StopId entry_to{ entry_it->first.second };
+				for (; arc_it != arcs_end && arc_it->to < entry_to; ++arc_it) {
+					arcs.push_back(*arc_it);
+				}
+				arcs.push_back(Arc{ .to = entry_to, .distance = entry_it->second });
+			}
+			arcs.insert(arcs.end(), arc_it, arcs_end);
+			offsets[from + 1] = static_cast<uint32_t>(arcs.size());
+		}
+
+		offsets_ = std::move(offsets);
+		arcs_ = std::move(arcs);
+		pending_entries_.clear();
+	}
+
+	bool DistanceTable::IsFrozen() const {
+		return pending_entries_.empty();
+	}
+
+	std::span<const uint32_t> DistanceTable::GetOffsets() const {
+		if (!IsFrozen()) {
+			throw std::logic_error{ "DistanceTable::GetOffsets: The table isn't frozen!" };
+		}
+		return offsets_;
+	}
+
+	std::span<const DistanceTable::Arc> DistanceTable::GetArcs() const {
+		if (!IsFrozen()) {
+			throw std::logic_error{ "DistanceTable::GetArcs: The table isn't frozen!" };
+		}
+		return arcs_;
+	}
+
+	std::optional<DistanceTable::Distance> DistanceTable::FindDirected(StopId from, StopId to) const {
+		if (const Arc* arc = FindArc(from, to)) {
+			return arc->distance;
+		}
+		if (const auto it = pending_entries_.find({ from, to }); it != pending_entries_.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	const DistanceTable::Arc* DistanceTable::FindArc(StopId from, StopId to) const {
+		if (from + size_t{ 1 } >= offsets_.size()) {
+			return nullptr;
+		}
+		const Arc* begin{ arcs_.data() + offsets_[from] };
+		const Arc* end{ arcs_.data() + offsets_[from + 1] };
+		const Arc* arc{ std::lower_bound(begin, end, to, [](const Arc& arc, StopId to) {
+			return arc.to < to;
+		}) };
+		return arc != end && arc->to == to ? arc : nullptr;
+	}
+}//transport_catalogue
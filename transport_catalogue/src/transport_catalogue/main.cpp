@@ -1,35 +1,82 @@
-#include "transport_catalogue.hpp"
-#include "request_handler.hpp"
-#include "json_reader.hpp"
-#include "transport_router.hpp"
-
-int main() {
-	using Catalogue = transport_catalogue::TransportCatalogue;
-
-	using JSONReader = json_reader::JsonReader;
-	using Configurator = transport_catalogue::configurator::json_io::DataBaseConfigurator;
-
-	using IOHandler = transport_catalogue::io_handler::json_io::DataBaseIOHandler;
-
-	Catalogue my_transport_catalogue{};
-
-		JSONReader my_json_reader{};
-		my_json_reader.ReadDocument();
-		
-		Configurator configurator{ &my_transport_catalogue };
-		if (auto render_node = my_json_reader.GetRenderSettingsNode(); render_node.has_value()) {
-			configurator.ReadMapRenderQuery(*render_node.value());
-		}
-		if (auto init_router_node = my_json_reader.GetInitRouterNode(); init_router_node.has_value()) {
-			configurator.ReadInitRouterQuery(*init_router_node.value());
-		}
-		if (auto base_node = my_json_reader.GetBaseRequestsNode(); base_node.has_value()) {
-			configurator.SetCatalogue(*base_node.value());
-
-			if (auto stat_node = my_json_reader.GetStatRequestsNode(); stat_node.has_value()) {
-				IOHandler io_handler{ &my_transport_catalogue };
-				io_handler.ProcessIOQueries(*stat_node.value());
-			}
-		}
-	return 0;
-}
\ No newline at end of file
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+#include "catalogue_snapshots.hpp"
+#include "transport_catalogue.hpp"
+#include "request_handler.hpp"
+#include "json_reader.hpp"
+#include "transport_router.hpp"
+
+//transport_catalogue										- base and stat requests from the input
+//transport_catalogue --compile-snapshot <path>				- saves the catalogue of the base requests to the file
+//transport_catalogue --serve-snapshot <path>				- answers the stat requests with the catalogue of the file
+int main(int argc, char* argv[]) {
+	using namespace std::literals::string_view_literals;
+
+	using Catalogue = transport_catalogue::TransportCatalogue;
+	using CatalogueSnapshots = transport_catalogue::CatalogueSnapshots;
+
+	using JSONReader = json_reader::JsonReader;
+	using Configurator = transport_catalogue::configurator::json_io::DataBaseConfigurator;
+
+	using IOHandler = transport_catalogue::io_handler::json_io::DataBaseIOHandler;
+
+	const std::string_view mode{ argc > 1 ? argv[1] : "" };
+	if (!mode.empty() && (argc != 3 || (mode != "--compile-snapshot"sv && mode != "--serve-snapshot"sv))) {
+		std::cerr << "Usage: " << argv[0] << " [--compile-snapshot <path> | --serve-snapshot <path>]" << std::endl;
+		return 1;
+	}
+
+	auto my_transport_catalogue{ std::make_shared<Catalogue>() };
+
+		JSONReader my_json_reader{};
+		my_json_reader.ReadDocument();
+
+		Configurator configurator{ my_transport_catalogue.get() };
+		if (mode == "--compile-snapshot"sv) {
+			//the settings aren't a part of the snapshot, they come with the stat requests
+			if (auto base_node = my_json_reader.GetBaseRequestsNode(); base_node.has_value()) {
+				configurator.SetCatalogue(*base_node.value());
+				try {
+					configurator.SaveSnapshot(argv[2]);
+				}
+				catch (const std::logic_error& error) {
+					std::cerr << error.what() << std::endl;
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		if (auto render_node = my_json_reader.GetRenderSettingsNode(); render_node.has_value()) {
+			configurator.ReadMapRenderQuery(*render_node.value());
+		}
+		if (auto init_router_node = my_json_reader.GetInitRouterNode(); init_router_node.has_value()) {
+			configurator.ReadInitRouterQuery(*init_router_node.value());
+		}
+		if (mode == "--serve-snapshot"sv) {
+			//a missing, foreign or broken file is told of like a wrong command line
+			try {
+				configurator.LoadSnapshot(argv[2]);
+			}
+			catch (const std::logic_error& error) {
+				std::cerr << error.what() << std::endl;
+				return 1;
+			}
+		}
+		else if (auto base_node = my_json_reader.GetBaseRequestsNode(); base_node.has_value()) {
+			configurator.SetCatalogue(*base_node.value());
+		}
+		else {
+			return 0;
+		}
+		CatalogueSnapshots snapshots{ std::move(my_transport_catalogue) };
+
+		if (auto stat_node = my_json_reader.GetStatRequestsNode(); stat_node.has_value()) {
+			IOHandler io_handler{ &snapshots };
+			io_handler.ProcessIOQueries(*stat_node.value());
+		}
+	return 0;
+}
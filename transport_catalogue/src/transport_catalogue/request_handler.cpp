@@ -1,575 +1,990 @@
-#include "request_handler.hpp"
-
-namespace transport_catalogue
-{
-	svg_renderer::Renderer renderer{};
-
-	namespace configurator
-	{
-		void IDataBaseConfigurator::ExecuteQueries() {
-			while (query_ptr_queue_.size() != 0) {
-				ExecuteQuery(const_cast<Query&>(*query_ptr_queue_.top()));
-				query_ptr_queue_.pop();
-			}
-		}
-
-		namespace json_io
-		{
-			InputReader::InputReader(
-				std::priority_queue<Query*,std::vector<Query*>
-				, QueryPtrCompare>* query_ref_queue
-				, std::deque<Query>* queries)
-			{
-				query_ptr_queue_ = query_ref_queue; //can't be represented with init-list, because is not base of InputReader
-				queries_ = queries; //can't be represented with init-list, because is not base of InputReader
-			}
-
-			size_t InputReader::ReadQueries(const json::Node& node) {
-				size_t queries_count{ node.AsArray().size() };
-
-				for (const json::Node& query_node : node.AsArray()) {
-					auto type_it = query_node.AsDict().find("type");
-					if (type_it->second.AsString() == "Stop") {
-						ProcessStopQuery(query_node);
-					}
-					else if(type_it->second.AsString() == "Bus"){
-						ProcessRouteQuery(query_node);
-					}
-					else {
-						std::ostringstream oss;
-						json::Print(json::Document{ node }, oss);
-						std::string error_message = {
-							"configurator::InputReader::ReadQueries(const json::Node&): No such query type!\nNode:\n"
-							+ oss.str()
-						};
-
-						throw std::logic_error{ error_message };
-					}
-				}
-				
-				return queries_count;
-			}
-
-			void InputReader::ProcessStopQuery(const json::Node& node) {
-				std::unordered_map<
-					std::pair<std::string_view, std::string_view>
-					, unsigned long, StringViewPairHasher
-				> distances;
-
-				std::string_view stop_name_sv = *(unique_strings.insert(node.AsDict().find("name")->second.AsString()).first);
-				for (auto& [dst_stop_name, distance] : node.AsDict().find("road_distances")->second.AsDict()) {
-					std::string_view dst_stop_name_sv = *(unique_strings.insert(dst_stop_name).first);
-					distances[{ stop_name_sv, dst_stop_name_sv }] = static_cast<unsigned long>(distance.AsInt());
-				}
-
-				if (!distances.empty())
-				{
-					queries_->push_back(std::move(Query{
-							.type = QueryType::DistanceSet
-							, .content = DistanceSetQueryContent{
-								.distances = std::move(distances)
-							}
-						}));
-
-					query_ptr_queue_->push(&queries_->back());
-				}
-
-				queries_->push_back(std::move(Query{
-						.type = QueryType::StopCreate
-						, .content = StopCreateQueryContent{
-							.name = std::move(stop_name_sv)
-							, .location = {
-								node.AsDict().find("latitude")->second.AsDouble()
-								, node.AsDict().find("longitude")->second.AsDouble()
-							}
-						}
-					}));
-
-				query_ptr_queue_->push(&queries_->back());
-			}
-
-			void InputReader::ProcessRouteQuery(const json::Node& node) {
-				std::vector<std::string_view> stops;
-				std::string_view route_name_sv = *(unique_strings.insert(node.AsDict().find("name")->second.AsString()).first);
-
-				for (const json::Node& stop : node.AsDict().find("stops")->second.AsArray()) {
-					std::string_view stop_name_sv = *(unique_strings.insert(stop.AsString()).first);
-					stops.push_back(stop_name_sv);
-				}
-
-				bool is_round_trip{ true };
-				if (node.AsDict().find("is_roundtrip")->second.AsBool() == false) {
-					stops = std::move(MakeRouteCircle(std::move(stops)));
-					is_round_trip = false;
-				}
-
-				queries_->push_back(std::move(Query{
-						.type = QueryType::RouteCreate
-						, .content = RouteCreateQueryContent{
-							.name = std::move(route_name_sv)
-							, .stops_names = std::move(stops)
-							, .is_round_trip = is_round_trip
-						}
-					}));
-
-				query_ptr_queue_->push(&queries_->back());
-			}
-
-			std::vector<std::string_view> InputReader::MakeRouteCircle(std::vector<std::string_view>&& stops) {
-				std::vector<std::string_view> stops_copy{};
-				stops_copy.reserve(stops.size());
-
-				for (auto it{ stops.begin() }; it != std::prev(stops.end()); it++) {
-					stops_copy.emplace_back(*it);
-				}
-
-				std::reverse(stops_copy.begin(), stops_copy.end());
-				stops.reserve(stops.size() + stops_copy.size());
-
-				for (auto it{ stops_copy.begin() }; it != stops_copy.end(); it++) {
-					stops.emplace_back(std::move(*it));
-				}
-
-				return std::move(stops);
-			}
-
-			void InputReader::ProcessInitRouterQuery(const json::Node& node) {
-				unsigned int bus_wait_time;
-				unsigned int bus_velocity;
-
-				const json::Dict& params = node.AsDict();
-				bus_wait_time = params.at("bus_wait_time").AsInt();
-				bus_velocity = params.at("bus_velocity").AsInt();
-
-				queries_->push_back(std::move(Query{
-						.type = QueryType::InitRouter
-						, .content = InitRouterQueryContent{
-							.bus_wait_time = bus_wait_time
-							, .bus_velocity = bus_velocity
-						}
-					}));
-
-				query_ptr_queue_->push(&queries_->back());
-			}
-
-			svg_renderer::Color InputReader::ParseColorFromJSON(const json::Node& node) {
-				if (node.IsString()) {
-					return { node.AsString() };
-				}
-				if (node.IsArray()) {
-					if (node.AsArray().size() == 3) {
-						const json::Array& color_array = node.AsArray();
-						return std::tuple<int, int, int>{ color_array[0].AsInt()
-														, color_array[1].AsInt()
-														, color_array[2].AsInt()
-						};
-					}
-					else if (node.AsArray().size() == 4) {
-						const json::Array& color_array = node.AsArray();
-						return std::tuple<int, int, int, double>{ color_array[0].AsInt()
-																, color_array[1].AsInt()
-																, color_array[2].AsInt()
-																, color_array[3].AsDouble()
-						};
-					}
-				}
-				throw std::logic_error{"svg_renderer::Color ParseColorFromJSON(const json::Node&): Unknown color type!"};
-			}
-			void InputReader::ProcessMapRenderQuery(const json::Node& node) {
-				svg_renderer::RenderSettings settings;
-				settings.width = node.AsDict().find("width")->second.AsDouble();
-				settings.height = node.AsDict().find("height")->second.AsDouble();
-
-				settings.padding = node.AsDict().find("padding")->second.AsDouble();
-
-				settings.line_width = node.AsDict().find("line_width")->second.AsDouble();
-				settings.stop_radius = node.AsDict().find("stop_radius")->second.AsDouble();
-
-				settings.bus_label_font_size = node.AsDict().find("bus_label_font_size")->second.AsInt();
-				settings.bus_label_offset = { node.AsDict().find("bus_label_offset")->second.AsArray()[0].AsDouble()
-											, node.AsDict().find("bus_label_offset")->second.AsArray()[1].AsDouble() };
-
-				settings.stop_label_font_size = node.AsDict().find("stop_label_font_size")->second.AsInt();
-				settings.stop_label_offset = { node.AsDict().find("stop_label_offset")->second.AsArray()[0].AsDouble()
-											, node.AsDict().find("stop_label_offset")->second.AsArray()[1].AsDouble() };
-
-				settings.underlayer_color = ParseColorFromJSON(node.AsDict().find("underlayer_color")->second);
-				settings.underlayer_width = node.AsDict().find("underlayer_width")->second.AsDouble();
-
-				for (const json::Node& node : node.AsDict().find("color_palette")->second.AsArray()) {
-					settings.palette.push_back(ParseColorFromJSON(node));
-				}
-
-				queries_->push_back(std::move(Query{
-					.type = QueryType::MapRender
-					, .content = std::move(settings)
-					}));
-
-				query_ptr_queue_->push(&queries_->back());
-			}
-
-			DataBaseConfigurator::DataBaseConfigurator(TransportCatalogue* catalogue) {
-				catalogue_ = std::move(catalogue); 	//Can't be represented with init-list
-													//, because is not base of DataBaseConfigurator.
-													//The other fields are already initialized.
-			}
-
-			void DataBaseConfigurator::SetCatalogue(const json::Node& node_ref) {
-				GetQueries(node_ref);
-				ExecuteQueries();
-			}
-
-			size_t DataBaseConfigurator::GetQueries(const json::Node& node_ref) {
-				return input_reader_.ReadQueries(node_ref);
-			}
-
-			void DataBaseConfigurator::ReadMapRenderQuery(const json::Node& node) {
-				input_reader_.ProcessMapRenderQuery(node);
-			}
-
-			void DataBaseConfigurator::ReadInitRouterQuery(const json::Node& node) {
-				input_reader_.ProcessInitRouterQuery(node);
-			}
-		}
-
-		void IDataBaseConfigurator::FindRouteStops(
-			std::vector<std::string_view>& stops_names_ref
-			, svg_renderer::RouteData& route_data
-		) {
-			for (const std::string_view stop_name_sv : stops_names_ref) {
-				auto it = std::find_if(queries_.begin(), queries_.end(), [&stop_name_sv](const Query& q)->bool {
-					if (q.type != QueryType::StopCreate) {
-						return false;
-					}
-					return stop_name_sv == std::get<StopCreateQueryContent>(q.content).name;
-					});
-
-				svg_renderer::StopData stop_data{
-					std::get<StopCreateQueryContent>(it->content).name
-					, std::get<StopCreateQueryContent>(it->content).location
-				};
-
-				route_data.stops.push_back(std::move(stop_data));
-			}
-		}
-
-		void IDataBaseConfigurator::ExecuteQuery(Query& query) {
-			switch (query.type) {
-			case QueryType::StopCreate:
-			{
-				catalogue_->AddStop(std::move(static_cast<std::string>(std::get<StopCreateQueryContent>(query.content).name))
-					, std::move(std::get<StopCreateQueryContent>(query.content).location)
-				);
-				break;
-			}
-			case QueryType::RouteCreate:
-			{
-				catalogue_->AddRoute(std::move(static_cast<std::string>(std::get<RouteCreateQueryContent>(query.content).name))
-					, std::move(std::get<RouteCreateQueryContent>(query.content).stops_names)
-				);
-				break;
-			}
-			case QueryType::DistanceSet:
-			{
-				for (auto& [names, distance] : std::get<DistanceSetQueryContent>(query.content).distances) {
-					catalogue_->SetDistanceBetweenStops(
-						catalogue_->GetStopPtr(names.first)
-						, catalogue_->GetStopPtr(names.second)
-						, distance
-					);
-				}
-				break;
-			}
-			case QueryType::InitRouter:
-			{
-				catalogue_->InitRouter({
-					.bus_wait_time = std::get<InitRouterQueryContent>(query.content).bus_wait_time
-					, .bus_velocity = std::get<InitRouterQueryContent>(query.content).bus_velocity
-					, .catalogue = catalogue_
-					}
-				);
-			}
-				break;
-			case QueryType::MapRender:
-			{				
-				for (Query& query_local : queries_) {
-					if (query_local.type == QueryType::RouteCreate) {
-						svg_renderer::RouteData route_data{  };
-						route_data.name = std::get<RouteCreateQueryContent>(query_local.content).name;
-						route_data.is_round_trip = std::get<RouteCreateQueryContent>(query_local.content).is_round_trip;
-						std::vector<std::string_view>& stops_names_ref{
-							std::get<RouteCreateQueryContent>(query_local.content).stops_names
-						};
-
-						FindRouteStops(stops_names_ref, route_data);
-
-						renderer.AddRoute(std::move(route_data));
-					}
-				}
-
-				renderer.SetSettings(std::move(std::get<svg_renderer::RenderSettings>(query.content)));
-				break;
-			}
-			default:
-				throw std::logic_error{ "DataBaseConfigurator::ExecuteQuery: Unknown query type!" };
-			}
-		}
-	}//configurator
-
-	namespace io_handler
-	{
-		void IDataBaseIOHandler::ExecuteQueries() {
-			while (query_queue_.size() != 0) {
-				ExecuteQuery(const_cast<Query&>(query_queue_.front()));
-				query_queue_.pop();
-			}
-		}
-		
-		namespace json_io
-		{
-			InputReader::InputReader(std::queue<Query>* query_queue) {
-				query_queue_ = query_queue; //can't be represented with init-list, because is not base of InputReader
-			}
-
-			size_t InputReader::ReadQueries(const json::Node& node) {
-				size_t queries_count{ node.AsArray().size() };
-
-				for (const json::Node& query_node : node.AsArray()) {
-					auto type_it = query_node.AsDict().find("type");
-					if (type_it->second.AsString() == "Stop") {
-						ProcessStopGetInfoQuery(query_node);
-					}
-					else if (type_it->second.AsString() == "Bus") {
-						ProcessRouteGetInfoQuery(query_node);
-					}
-					else if (type_it->second.AsString() == "Map") {
-						ProcessDrawMapQuery(query_node);
-					}
-					else if (type_it->second.AsString() == "Route") {
-						ProcessBuildRouteQuery(query_node);
-					}
-					else {
-						std::ostringstream oss;
-						json::Print(json::Document{ node }, oss);
-						std::string error_message = {
-							"io_handler::InputReader::ReadQueries(const json::Node&): No such query type!\nNode:\n"
-							+ oss.str()
-						};
-
-						throw std::logic_error{ error_message };
-					}
-				}
-
-				return queries_count;
-			}
-
-			void InputReader::ProcessDrawMapQuery(const json::Node& node)
-			{
-				Query query{ 
-					.id = node.AsDict().find("id")->second.AsInt()
-					, .type = QueryType::DrawMap
-					, .content = std::monostate{}
-				};
-				query_queue_->push(std::move(query));
-			}
-
-			void InputReader::ProcessRouteGetInfoQuery(const json::Node& node) {
-				Query query{ 
-					.id = node.AsDict().find("id")->second.AsInt()
-					, .type = QueryType::RouteInfo
-					, .content = RouteInfoQueryContent{ .name = node.AsDict().find("name")->second.AsString() }
-				};
-				query_queue_->push(std::move(query));
-			}
-
-			void InputReader::ProcessStopGetInfoQuery(const json::Node& node) {
-				Query query{ 
-					.id = node.AsDict().find("id")->second.AsInt()
-					, .type = QueryType::StopInfo
-					, .content = StopInfoQueryContent{ .name = node.AsDict().find("name")->second.AsString() }
-				};
-				query_queue_->push(std::move(query));
-			}
-
-			void InputReader::ProcessBuildRouteQuery(const json::Node& node) {
-				Query query{
-					.id = node.AsDict().find("id")->second.AsInt()
-					, .type = QueryType::BuildRoute
-					, .content = BuildRouteQueryContent{
-							.from = node.AsDict().find("from")->second.AsString()
-							, .to = node.AsDict().find("to")->second.AsString()
-						}
-				};
-				query_queue_->push(std::move(query));
-			}
-
-			void DataBaseIOHandler::PrintStopInfo(const details::StopInfo& info, const int id) {
-				using namespace std::literals::string_literals;
-				json::Array routes;
-				if (!info.routes->empty())
-				{
-					std::vector<std::string_view> route_names;
-					for (details::Route* route_ptr : *info.routes) {
-						route_names.push_back(route_ptr->name);
-					}
-
-					std::sort(route_names.begin(), route_names.end(), [](std::string_view lhs, std::string_view rhs) {
-						return std::lexicographical_compare(lhs.begin(), lhs.end()
-							, rhs.begin(), rhs.end()
-						);
-					});
-
-					json::Array routes_array;
-					for (std::string_view route_name_sv : route_names) {
-						routes_array.push_back(static_cast<std::string>(route_name_sv));
-					}
-
-					answer_.push_back(json::Builder{}.StartDict()
-							.Key("request_id"s).Value(id)
-							.Key("buses"s).Value(routes_array)
-						.EndDict().Build()
-					);
-				}
-				else {
-					answer_.push_back(json::Builder{}.StartDict()
-							.Key("request_id"s).Value(id)
-							.Key("buses"s).Value(json::Array{})
-						.EndDict().Build()
-					);
-				}
-			}
-
-			void DataBaseIOHandler::PrintRouteInfo(const details::RouteInfo& info, const int id) {
-				using namespace std::literals::string_literals;
-				answer_.push_back(json::Builder{}.StartDict()
-						.Key("request_id"s).Value(id)
-						.Key("route_length"s).Value(static_cast<int>(info.distance_total))
-						.Key("stop_count"s).Value(static_cast<int>(info.stops_count))
-						.Key("unique_stop_count"s).Value(static_cast<int>(info.unique_stops_count))
-						.Key("curvature"s).Value(static_cast<double>(info.curvature))
-					.EndDict().Build()
-				);
-			}
-
-			void DataBaseIOHandler::PrintRouterBuildedInfo(
-				const std::optional<const transport_router::RouteInfo* const>&& info
-				, const int id
-			) {
-				using namespace std::literals::string_literals;
-				if (!info) {
-					answer_.push_back(json::Builder{}.StartDict()
-						.Key("request_id"s).Value(id)
-						.Key("error_message"s).Value("not found"s)
-						.EndDict().Build()
-					);
-					return;
-				}
-
-				json::Array items;
-				for (const auto& item : info.value()->items) {
-					if (const auto wait_item = std::get_if<transport_router::WaitItem>(&item.content)) {
-						items.push_back(
-							json::Dict{
-								{"type", json::Node("Wait"s)}
-								, {"stop_name", json::Node(static_cast<std::string>(wait_item->stop_name))}
-								, {"time", json::Node(static_cast<int>(wait_item->time))}
-							}
-						);
-					}
-
-					if (const auto bus_item = std::get_if<transport_router::BusItem>(&item.content)) {
-						items.push_back(
-							json::Dict{
-								{"type", json::Node("Bus"s)}
-								, {"bus", json::Node(static_cast<std::string>(bus_item->bus))}
-								, {"span_count", json::Node(static_cast<int>(bus_item->span_count))}
-								, {"time", json::Node(bus_item->time)}
-							}
-						);
-					}
-				}
-
-				answer_.push_back(json::Builder{}.StartDict()
-					.Key("request_id"s).Value(id)
-					.Key("total_time"s).Value(info.value()->total_time)
-					.Key("items"s).Value(items)
-					.EndDict().Build()
-				);
-			}
-
-			DataBaseIOHandler::DataBaseIOHandler(TransportCatalogue* catalogue) {
-				catalogue_ = catalogue;//can't be represented with init-list, because is not base of DataBaseIOHandler
-				//the other fields are already initialized
-			}
-
-			void DataBaseIOHandler::ProcessIOQueries(const json::Node& node_ref) {
-				GetQueries(node_ref);
-				ExecuteQueries();
-				PrintAnswers();
-			}
-
-			size_t DataBaseIOHandler::GetQueries(const json::Node& node_ref) {
-				return input_reader_.ReadQueries(node_ref);
-			}
-
-			void DataBaseIOHandler::ExecuteQuery(Query& query) {
-				using namespace std::literals::string_literals;
-				switch (query.type) {
-				case QueryType::StopInfo:
-					try {
-						PrintStopInfo(catalogue_->GetStopInfo(std::get<StopInfoQueryContent>(query.content).name), query.id);
-					}
-					catch (std::logic_error&) {
-						answer_.push_back(json::Builder{}.StartDict()
-								.Key("request_id"s).Value(query.id)
-								.Key("error_message"s).Value("not found"s)
-							.EndDict().Build()
-						);
-					}
-					break;
-				case QueryType::RouteInfo:
-					try {
-						PrintRouteInfo(catalogue_->GetRouteInfo(std::get<RouteInfoQueryContent>(query.content).name), query.id);
-					}
-					catch (std::logic_error&) {
-						answer_.push_back(json::Builder{}.StartDict()
-							.Key("request_id"s).Value(query.id)
-							.Key("error_message"s).Value("not found"s)
-							.EndDict().Build()
-						);
-					}
-					break;
-				case QueryType::BuildRoute:
-				{
-					auto route_info = catalogue_->BuildRoute(
-						std::get<BuildRouteQueryContent>(query.content).from,
-						std::get<BuildRouteQueryContent>(query.content).to
-					);
-					PrintRouterBuildedInfo(std::move(route_info), query.id);
-				}
-					break;
-				case QueryType::DrawMap:
-				{
-					std::ostringstream oss{};
-					renderer.Render(oss);
-					answer_.push_back(json::Builder{}.StartDict()
-						.Key("request_id"s).Value(query.id)
-						.Key("map"s).Value(oss.str())
-						.EndDict().Build()
-					);
-					break;
-				}
-				default:
-					throw std::logic_error{ "DataBaseIOHandler::ExecuteQuery: Unknown query type!" };
-				}
-			}
-
-			void DataBaseIOHandler::PrintAnswers(std::ostream& output_stream) {
-				if (answer_.empty()) {
-					return;
-				}
-				json::Print(json::Document{ answer_ }, output_stream);
-			}
-		}//json_io
-	}//io_handler
-}//transport_catalogue
+#include "request_handler.hpp"
+
+namespace transport_catalogue
+{
+	namespace configurator
+	{
+		void IDataBaseConfigurator::ExecuteQueries() {
+			while (query_ptr_queue_.size() != 0) {
+				ExecuteQuery(const_cast<Query&>(*query_ptr_queue_.top()));
+				query_ptr_queue_.pop();
+			}
+		}
+
+		void IInputReader::PushQuery(Query&& query) {
+			query.order = queries_->size();
+			queries_->push_back(std::move(query));
+			query_ptr_queue_->push(&queries_->back());
+		}
+
+		void IInputReader::UpdateSourceChecksum(std::string_view bytes) {
+			for (const char c : bytes) {
+				*source_checksum_ ^= static_cast<unsigned char>(c);
+				*source_checksum_ *= 1099511628211ull; //FNV-1a prime
+			}
+		}
+
+		void IInputReader::UpdateSourceChecksum(double value) {
+			UpdateSourceChecksum(std::string_view{ reinterpret_cast<const char*>(&value), sizeof(value) });
+		}
+
+		void IInputReader::UpdateSourceChecksum(uint64_t value) {
+			UpdateSourceChecksum(std::string_view{ reinterpret_cast<const char*>(&value), sizeof(value) });
+		}
+
+		namespace json_io
+		{
+			InputReader::InputReader(
+				std::priority_queue<Query*,std::vector<Query*>
+				, QueryPtrCompare>* query_ref_queue
+				, std::deque<Query>* queries
+				, string_interner::StringInterner* names
+				, uint64_t* source_checksum)
+			{
+				query_ptr_queue_ = query_ref_queue; //can't be represented with init-list, because is not base of InputReader
+				queries_ = queries; //can't be represented with init-list, because is not base of InputReader
+				names_ = names; //can't be represented with init-list, because is not base of InputReader
+				source_checksum_ = source_checksum; //can't be represented with init-list, because is not base of InputReader
+			}
+
+			size_t InputReader::ReadQueries(const json::Node& node) {
+				size_t queries_count{ node.AsArray().size() };
+
+				for (const json::Node& query_node : node.AsArray()) {
+					auto type_it = query_node.AsDict().find("type");
+					if (type_it->second.AsString() == "Stop") {
+						ProcessStopQuery(query_node);
+					}
+					else if(type_it->second.AsString() == "Bus"){
+						ProcessRouteQuery(query_node);
+					}
+					else {
+						std::ostringstream oss;
+						json::Print(json::Document{ node }, oss);
+						std::string error_message = {
+							"configurator::InputReader::ReadQueries(const json::Node&): No such query type!\nNode:\n"
+							+ oss.str()
+						};
+
+						throw std::logic_error{ error_message };
+					}
+				}
+				
+				return queries_count;
+			}
+
+			void InputReader::ProcessStopQuery(const json::Node& node) {
+				std::unordered_map<
+					std::pair<std::string_view, std::string_view>
+					, unsigned long, StringViewPairHasher
+				> distances;
+
+				std::string_view stop_name_sv = names_->Intern(node.AsDict().find("name")->second.AsString());
+				const double latitude{ node.AsDict().find("latitude")->second.AsDouble() };
+				const double longitude{ node.AsDict().find("longitude")->second.AsDouble() };
+				//the sizes keep the names apart, the distances are read in the order of the names
+				UpdateSourceChecksum(std::string_view{ "Stop" });
+				UpdateSourceChecksum(static_cast<uint64_t>(stop_name_sv.size()));
+				UpdateSourceChecksum(stop_name_sv);
+				UpdateSourceChecksum(latitude);
+				UpdateSourceChecksum(longitude);
+				for (auto& [dst_stop_name, distance] : node.AsDict().find("road_distances")->second.AsDict()) {
+					std::string_view dst_stop_name_sv = names_->Intern(dst_stop_name);
+					distances[{ stop_name_sv, dst_stop_name_sv }] = static_cast<unsigned long>(distance.AsInt());
+					UpdateSourceChecksum(static_cast<uint64_t>(dst_stop_name_sv.size()));
+					UpdateSourceChecksum(dst_stop_name_sv);
+					UpdateSourceChecksum(static_cast<uint64_t>(distance.AsInt()));
+				}
+
+				if (!distances.empty())
+				{
+					PushQuery(Query{
+							.type = QueryType::DistanceSet
+							, .content = DistanceSetQueryContent{
+								.distances = std::move(distances)
+							}
+						});
+				}
+
+				PushQuery(Query{
+						.type = QueryType::StopCreate
+						, .content = StopCreateQueryContent{
+							.name = std::move(stop_name_sv)
+							, .location = { latitude, longitude }
+						}
+					});
+			}
+
+			void InputReader::ProcessRouteQuery(const json::Node& node) {
+				std::vector<std::string_view> stops;
+				std::string_view route_name_sv = names_->Intern(node.AsDict().find("name")->second.AsString());
+				const bool is_roundtrip_node{ node.AsDict().find("is_roundtrip")->second.AsBool() };
+				UpdateSourceChecksum(std::string_view{ is_roundtrip_node ? "Bus circle" : "Bus line" });
+				UpdateSourceChecksum(static_cast<uint64_t>(route_name_sv.size()));
+				UpdateSourceChecksum(route_name_sv);
+
+				for (const json::Node& stop : node.AsDict().find("stops")->second.AsArray()) {
+					std::string_view stop_name_sv = names_->Intern(stop.AsString());
+					stops.push_back(stop_name_sv);
+					UpdateSourceChecksum(static_cast<uint64_t>(stop_name_sv.size()));
+					UpdateSourceChecksum(stop_name_sv);
+				}
+
+				bool is_round_trip{ true };
+				if (is_roundtrip_node == false) {
+					stops = std::move(MakeRouteCircle(std::move(stops)));
+					is_round_trip = false;
+				}
+
+				PushQuery(Query{
+						.type = QueryType::RouteCreate
+						, .content = RouteCreateQueryContent{
+							.name = std::move(route_name_sv)
+							, .stops_names = std::move(stops)
+							, .is_round_trip = is_round_trip
+						}
+					});
+			}
+
+			std::vector<std::string_view> InputReader::MakeRouteCircle(std::vector<std::string_view>&& stops) {
+				std::vector<std::string_view> stops_copy{};
+				stops_copy.reserve(stops.size());
+
+				for (auto it{ stops.begin() }; it != std::prev(stops.end()); it++) {
+					stops_copy.emplace_back(*it);
+				}
+
+				std::reverse(stops_copy.begin(), stops_copy.end());
+				stops.reserve(stops.size() + stops_copy.size());
+
+				for (auto it{ stops_copy.begin() }; it != stops_copy.end(); it++) {
+					stops.emplace_back(std::move(*it));
+				}
+
+				return std::move(stops);
+			}
+
+			void InputReader::ProcessInitRouterQuery(const json::Node& node) {
+				unsigned int bus_wait_time;
+				unsigned int bus_velocity;
+				transport_router::RouterEngine engine{ transport_router::RouterEngine::FloydWarshall };
+				//the count is 0 if it isn't known
+				size_t threads_count{ std::max(std::thread::hardware_concurrency(), 1u) };
+				transport_router::GraphModel graph_model{ transport_router::GraphModel::SubRoutes };
+
+				const json::Dict& params = node.AsDict();
+				bus_wait_time = params.at("bus_wait_time").AsInt();
+				bus_velocity = params.at("bus_velocity").AsInt();
+				if (auto it = params.find("router_engine"); it != params.end()) {
+					engine = ParseRouterEngineFromJSON(it->second);
+				}
+				if (auto it = params.find("router_threads"); it != params.end()) {
+					threads_count = ParseSizeFromJSON(it->second, 1, transport_router::MAX_THREADS_COUNT, "router_threads");
+				}
+				if (auto it = params.find("graph_model"); it != params.end()) {
+					graph_model = ParseGraphModelFromJSON(it->second);
+				}
+				std::string cache_file{};
+				if (auto it = params.find("router_cache_file"); it != params.end()) {
+					cache_file = it->second.AsString();
+				}
+				size_t route_cache_bytes{ transport_router::DEFAULT_ROUTE_CACHE_BYTES };
+				if (auto it = params.find("route_cache_bytes"); it != params.end()) {
+					route_cache_bytes = ParseSizeFromJSON(it->second, 0, std::numeric_limits<size_t>::max(), "route_cache_bytes");
+				}
+
+				PushQuery(Query{
+						.type = QueryType::InitRouter
+						, .content = InitRouterQueryContent{
+							.bus_wait_time = bus_wait_time
+							, .bus_velocity = bus_velocity
+							, .engine = engine
+							, .threads_count = threads_count
+							, .graph_model = graph_model
+							, .cache_file = std::move(cache_file)
+							, .route_cache_bytes = route_cache_bytes
+						}
+					});
+			}
+
+			svg_renderer::Color InputReader::ParseColorFromJSON(const json::Node& node) {
+				if (node.IsString()) {
+					return { node.AsString() };
+				}
+				if (node.IsArray()) {
+					if (node.AsArray().size() == 3) {
+						const json::Array& color_array = node.AsArray();
+						return std::tuple<int, int, int>{ color_array[0].AsInt()
+														, color_array[1].AsInt()
+														, color_array[2].AsInt()
+						};
+					}
+					else if (node.AsArray().size() == 4) {
+						const json::Array& color_array = node.AsArray();
+						return std::tuple<int, int, int, double>{ color_array[0].AsInt()
+																, color_array[1].AsInt()
+																, color_array[2].AsInt()
+																, color_array[3].AsDouble()
+						};
+					}
+				}
+				throw std::logic_error{"svg_renderer::Color ParseColorFromJSON(const json::Node&): Unknown color type!"};
+			}
+
+			transport_router::RouterEngine InputReader::ParseRouterEngineFromJSON(const json::Node& node) {
+				if (node.AsString() == "floyd_warshall") {
+					return transport_router::RouterEngine::FloydWarshall;
+				}
+				if (node.AsString() == "dijkstra") {
+					return transport_router::RouterEngine::Dijkstra;
+				}
+				if (node.AsString() == "contraction_hierarchies") {
+					return transport_router::RouterEngine::ContractionHierarchies;
+				}
+				if (node.AsString() == "a_star") {
+					return transport_router::RouterEngine::AStar;
+				}
+				throw std::logic_error{ "transport_router::RouterEngine ParseRouterEngineFromJSON(const json::Node&): Unknown router engine!" };
+			}
+
+			transport_router::GraphModel InputReader::ParseGraphModelFromJSON(const json::Node& node) {
+				if (node.AsString() == "sub_routes") {
+					return transport_router::GraphModel::SubRoutes;
+				}
+				if (node.AsString() == "transfers") {
+					return transport_router::GraphModel::Transfers;
+				}
+				throw std::logic_error{ "transport_router::GraphModel ParseGraphModelFromJSON(const json::Node&): Unknown graph model!" };
+			}
+
+			size_t InputReader::ParseSizeFromJSON(const json::Node& node, size_t min_size, size_t max_size, std::string_view setting) {
+				if (node.IsDouble()) {
+					const double size{ node.AsDouble() };
+					//2^digits is the first double beyond size_t, so the cast below is defined
+					if (size == std::floor(size) && size >= static_cast<double>(min_size)
+						&& size <= static_cast<double>(max_size)
+						&& size < std::ldexp(1., std::numeric_limits<size_t>::digits))
+					{
+						return std::min(static_cast<size_t>(size), max_size);
+					}
+				}
+				throw std::logic_error{ "size_t ParseSizeFromJSON(const json::Node&, size_t, size_t, std::string_view): "
+					+ std::string{ setting } + " is out of range!" };
+			}
+			void InputReader::ProcessMapRenderQuery(const json::Node& node) {
+				svg_renderer::RenderSettings settings;
+				settings.width = node.AsDict().find("width")->second.AsDouble();
+				settings.height = node.AsDict().find("height")->second.AsDouble();
+
+				settings.padding = node.AsDict().find("padding")->second.AsDouble();
+
+				settings.line_width = node.AsDict().find("line_width")->second.AsDouble();
+				settings.stop_radius = node.AsDict().find("stop_radius")->second.AsDouble();
+
+				settings.bus_label_font_size = node.AsDict().find("bus_label_font_size")->second.AsInt();
+				settings.bus_label_offset = { node.AsDict().find("bus_label_offset")->second.AsArray()[0].AsDouble()
+											, node.AsDict().find("bus_label_offset")->second.AsArray()[1].AsDouble() };
+
+				settings.stop_label_font_size = node.AsDict().find("stop_label_font_size")->second.AsInt();
+				settings.stop_label_offset = { node.AsDict().find("stop_label_offset")->second.AsArray()[0].AsDouble()
+											, node.AsDict().find("stop_label_offset")->second.AsArray()[1].AsDouble() };
+
+				settings.underlayer_color = ParseColorFromJSON(node.AsDict().find("underlayer_color")->second);
+				settings.underlayer_width = node.AsDict().find("underlayer_width")->second.AsDouble();
+
+				for (const json::Node& node : node.AsDict().find("color_palette")->second.AsArray()) {
+					settings.palette.push_back(ParseColorFromJSON(node));
+				}
+
+				PushQuery(Query{
+					.type = QueryType::MapRender
+					, .content = std::move(settings)
+					});
+			}
+
+			DataBaseConfigurator::DataBaseConfigurator(TransportCatalogue* catalogue)
+				: input_reader_{ &query_ptr_queue_, &queries_, &catalogue->GetNames(), &source_checksum_ }
+			{
+				catalogue_ = std::move(catalogue); 	//Can't be represented with init-list
+													//, because is not base of DataBaseConfigurator.
+													//The other fields are already initialized.
+			}
+
+			void DataBaseConfigurator::SetCatalogue(const json::Node& node_ref) {
+				ChangeCatalogue(node_ref);
+				catalogue_->Finalize();
+			}
+
+			void DataBaseConfigurator::ChangeCatalogue(const json::Node& node_ref) {
+				GetQueries(node_ref);
+				ExecuteQueries();
+			}
+
+			void DataBaseConfigurator::LoadSnapshot(const std::string& path) {
+				//the saved checksum stands for the base requests the snapshot was compiled of
+				//, so the routes cache file is shared with the run reading them
+				source_checksum_ = catalogue_->LoadSnapshot(path);
+				ExecuteQueries();
+			}
+
+			void DataBaseConfigurator::SaveSnapshot(const std::string& path) const {
+				catalogue_->SaveSnapshot(path, source_checksum_);
+			}
+
+			size_t DataBaseConfigurator::GetQueries(const json::Node& node_ref) {
+				return input_reader_.ReadQueries(node_ref);
+			}
+
+			void DataBaseConfigurator::ReadMapRenderQuery(const json::Node& node) {
+				input_reader_.ProcessMapRenderQuery(node);
+			}
+
+			void DataBaseConfigurator::ReadInitRouterQuery(const json::Node& node) {
+				input_reader_.ProcessInitRouterQuery(node);
+			}
+		}
+
+		void IDataBaseConfigurator::ExecuteQuery(Query& query) {
+			switch (query.type) {
+			case QueryType::StopCreate:
+			{
+				catalogue_->AddStop(std::get<StopCreateQueryContent>(query.content).name
+					, std::get<StopCreateQueryContent>(query.content).location
+				);
+				break;
+			}
+			case QueryType::RouteCreate:
+			{
+				catalogue_->AddRoute(std::get<RouteCreateQueryContent>(query.content).name
+					, std::move(std::get<RouteCreateQueryContent>(query.content).stops_names)
+					, std::get<RouteCreateQueryContent>(query.content).is_round_trip
+				);
+				break;
+			}
+			case QueryType::DistanceSet:
+			{
+				for (auto& [names, distance] : std::get<DistanceSetQueryContent>(query.content).distances) {
+					catalogue_->SetDistanceBetweenStops(
+						catalogue_->GetStopId(names.first)
+						, catalogue_->GetStopId(names.second)
+						, distance
+					);
+				}
+				break;
+			}
+			case QueryType::InitRouter:
+			{
+				catalogue_->InitRouter({
+					.bus_wait_time = std::get<InitRouterQueryContent>(query.content).bus_wait_time
+					, .bus_velocity = std::get<InitRouterQueryContent>(query.content).bus_velocity
+					, .catalogue = catalogue_
+					, .engine = std::get<InitRouterQueryContent>(query.content).engine
+					, .threads_count = std::get<InitRouterQueryContent>(query.content).threads_count
+					, .graph_model = std::get<InitRouterQueryContent>(query.content).graph_model
+					, .cache_file = std::get<InitRouterQueryContent>(query.content).cache_file
+					, .source_checksum = source_checksum_
+					, .route_cache_bytes = std::get<InitRouterQueryContent>(query.content).route_cache_bytes
+					}
+				);
+			}
+				break;
+			case QueryType::MapRender:
+			{
+				//the routes are taken from the catalogue, so a catalogue loaded from a snapshot is drawn the same way
+				catalogue_->SetRenderSettings(std::move(std::get<svg_renderer::RenderSettings>(query.content)));
+				break;
+			}
+			default:
+				throw std::logic_error{ "DataBaseConfigurator::ExecuteQuery: Unknown query type!" };
+			}
+		}
+	}//configurator
+
+	namespace io_handler
+	{
+		void IDataBaseIOHandler::ExecuteQueries() {
+			while (query_queue_.size() != 0) {
+				catalogue_ = snapshots_->Pin();
+				if (!catalogue_) {
+					throw std::logic_error{ "DataBaseIOHandler::ExecuteQueries: No catalogue is published!" };
+				}
+
+				PrefetchRoutes();
+				while (query_queue_.size() != 0 && query_queue_.front().type != QueryType::Update) {
+					ExecuteQuery(const_cast<Query&>(query_queue_.front()));
+					query_queue_.pop_front();
+				}
+				//the update publishes the next snapshot, the one pinned here is let go to be reclaimed
+				catalogue_.reset();
+				if (query_queue_.size() != 0) {
+					ExecuteQuery(const_cast<Query&>(query_queue_.front()));
+					query_queue_.pop_front();
+				}
+			}
+		}
+
+		void IDataBaseIOHandler::PrefetchRoutes() {
+			std::vector<transport_router::RouteRequest> requests;
+			for (const Query& query : query_queue_) {
+				if (query.type == QueryType::Update) {
+					break;
+				}
+				if (query.type == QueryType::BuildRoute) {
+					requests.push_back({
+						std::get<BuildRouteQueryContent>(query.content).from
+						, std::get<BuildRouteQueryContent>(query.content).to
+					});
+				}
+			}
+			if (requests.empty()) {
+				return;
+			}
+
+			for (auto& route_info : catalogue_->BuildRoutes(requests)) {
+				prefetched_routes_.push_back(std::move(route_info));
+			}
+		}
+		
+		namespace json_io
+		{
+			InputReader::InputReader(std::deque<Query>* query_queue) {
+				query_queue_ = query_queue; //can't be represented with init-list, because is not base of InputReader
+			}
+
+			size_t InputReader::ReadQueries(const json::Node& node) {
+				size_t queries_count{ node.AsArray().size() };
+
+				for (const json::Node& query_node : node.AsArray()) {
+					auto type_it = query_node.AsDict().find("type");
+					if (type_it->second.AsString() == "Stop") {
+						ProcessStopGetInfoQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Bus") {
+						ProcessRouteGetInfoQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Map") {
+						ProcessDrawMapQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Route") {
+						ProcessBuildRouteQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Reachable") {
+						ProcessReachableQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Matrix") {
+						ProcessMatrixQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Nearest") {
+						ProcessNearestQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "StopsInBox") {
+						ProcessStopsInBoxQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "Update") {
+						ProcessUpdateQuery(query_node);
+					}
+					else if (type_it->second.AsString() == "RouterStats") {
+						ProcessRouterStatsQuery(query_node);
+					}
+					else {
+						std::ostringstream oss;
+						json::Print(json::Document{ node }, oss);
+						std::string error_message = {
+							"io_handler::InputReader::ReadQueries(const json::Node&): No such query type!\nNode:\n"
+							+ oss.str()
+						};
+
+						throw std::logic_error{ error_message };
+					}
+				}
+
+				return queries_count;
+			}
+
+			void InputReader::ProcessDrawMapQuery(const json::Node& node)
+			{
+				Query query{ 
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::DrawMap
+					, .content = std::monostate{}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessRouteGetInfoQuery(const json::Node& node) {
+				Query query{ 
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::RouteInfo
+					, .content = RouteInfoQueryContent{ .name = node.AsDict().find("name")->second.AsString() }
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessStopGetInfoQuery(const json::Node& node) {
+				Query query{ 
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::StopInfo
+					, .content = StopInfoQueryContent{ .name = node.AsDict().find("name")->second.AsString() }
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessBuildRouteQuery(const json::Node& node) {
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::BuildRoute
+					, .content = BuildRouteQueryContent{
+							.from = node.AsDict().find("from")->second.AsString()
+							, .to = node.AsDict().find("to")->second.AsString()
+						}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessReachableQuery(const json::Node& node) {
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::Reachable
+					, .content = ReachableQueryContent{
+							.from = node.AsDict().find("from")->second.AsString()
+							, .max_time = node.AsDict().find("max_time")->second.AsDouble()
+						}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessMatrixQuery(const json::Node& node) {
+				auto read_names = [](const json::Node& names_node) {
+					std::vector<std::string> names;
+					for (const json::Node& name_node : names_node.AsArray()) {
+						names.push_back(name_node.AsString());
+					}
+					return names;
+				};
+
+				auto items_it{ node.AsDict().find("items") };
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::Matrix
+					, .content = MatrixQueryContent{
+							.from = read_names(node.AsDict().find("from")->second)
+							, .to = read_names(node.AsDict().find("to")->second)
+							, .with_items = items_it != node.AsDict().end() && items_it->second.AsBool()
+						}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessNearestQuery(const json::Node& node) {
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::Nearest
+					, .content = NearestQueryContent{
+							.location = geo::Coordinates{
+								node.AsDict().find("latitude")->second.AsDouble()
+								, node.AsDict().find("longitude")->second.AsDouble()
+							}
+							, .count = static_cast<size_t>(std::max(node.AsDict().find("count")->second.AsInt(), 0))
+						}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessStopsInBoxQuery(const json::Node& node) {
+				//a box with min_longitude > max_longitude crosses the 180th meridian
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::StopsInBox
+					, .content = StopsInBoxQueryContent{
+							.box = geo_index::GeoIndex::Box{
+								.min_lat = node.AsDict().find("min_latitude")->second.AsDouble()
+								, .max_lat = node.AsDict().find("max_latitude")->second.AsDouble()
+								, .min_lng = node.AsDict().find("min_longitude")->second.AsDouble()
+								, .max_lng = node.AsDict().find("max_longitude")->second.AsDouble()
+							}
+						}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessUpdateQuery(const json::Node& node) {
+				//the changes are in the format of the base requests
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::Update
+					, .content = UpdateQueryContent{ .base_requests = node.AsDict().find("base_requests")->second }
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void InputReader::ProcessRouterStatsQuery(const json::Node& node) {
+				Query query{
+					.id = node.AsDict().find("id")->second.AsInt()
+					, .type = QueryType::RouterStats
+					, .content = std::monostate{}
+				};
+				query_queue_->push_back(std::move(query));
+			}
+
+			void DataBaseIOHandler::PrintStopInfo(const details::StopInfo& info, const int id) {
+				using namespace std::literals::string_literals;
+				if (!info.routes.empty())
+				{
+					//the published catalogue is finalized, so the routes come sorted by the names
+					json::Array routes_array;
+					routes_array.reserve(info.routes.size());
+					for (const details::RouteId route : info.routes) {
+						routes_array.emplace_back(static_cast<std::string>(catalogue_->GetRouteName(route)));
+					}
+
+					answer_.push_back(json::Builder{}.StartDict()
+							.Key("request_id"s).Value(id)
+							.Key("buses"s).Value(std::move(routes_array))
+						.EndDict().Build()
+					);
+				}
+				else {
+					answer_.push_back(json::Builder{}.StartDict()
+							.Key("request_id"s).Value(id)
+							.Key("buses"s).Value(json::Array{})
+						.EndDict().Build()
+					);
+				}
+			}
+
+			void DataBaseIOHandler::PrintNearestStops(
+				const std::vector<details::StopId>& stops
+				, geo::Coordinates location
+				, const int id
+			) {
+				using namespace std::literals::string_literals;
+				json::Array stops_array;
+				stops_array.reserve(stops.size());
+				for (const details::StopId stop : stops) {
+					//the rounding takes acos out of its domain for the points at the same place
+					const double distance{ geo::ComputeDistance(location, catalogue_->GetStopLocation(stop)) };
+					stops_array.push_back(
+						json::Dict{
+							{"stop_name", json::Node(static_cast<std::string>(catalogue_->GetStopName(stop)))}
+							, {"distance", json::Node(std::isfinite(distance) ? distance : 0.)}
+						}
+					);
+				}
+
+				answer_.push_back(json::Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("stops"s).Value(std::move(stops_array))
+					.EndDict().Build()
+				);
+			}
+
+			void DataBaseIOHandler::PrintStopsInBox(
+				const std::vector<details::StopId>& stops
+				, const int id
+			) {
+				using namespace std::literals::string_literals;
+				json::Array stops_array;
+				stops_array.reserve(stops.size());
+				for (const details::StopId stop : stops) {
+					stops_array.emplace_back(static_cast<std::string>(catalogue_->GetStopName(stop)));
+				}
+
+				answer_.push_back(json::Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("stops"s).Value(std::move(stops_array))
+					.EndDict().Build()
+				);
+			}
+
+			void DataBaseIOHandler::PrintRouterStats(
+				const ::graph::IRouter<double>::SearchStats& search_stats
+				, const lru_cache::CacheStats& cache_stats
+				, const int id
+			) {
+				using namespace std::literals::string_literals;
+				//the settled vertices and the bytes add up beyond int, so they're given as doubles
+				answer_.push_back(json::Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("searches_count"s).Value(static_cast<int>(search_stats.searches_count))
+					.Key("settled_vertices_count"s).Value(static_cast<double>(search_stats.settled_vertices_count))
+					.Key("route_cache"s).StartDict()
+						.Key("hits_count"s).Value(static_cast<int>(cache_stats.hits_count))
+						.Key("misses_count"s).Value(static_cast<int>(cache_stats.misses_count))
+						.Key("evictions_count"s).Value(static_cast<int>(cache_stats.evictions_count))
+						.Key("invalidations_count"s).Value(static_cast<int>(cache_stats.invalidations_count))
+						.Key("entries_count"s).Value(static_cast<int>(cache_stats.entries_count))
+						.Key("bytes_used"s).Value(static_cast<double>(cache_stats.bytes_used))
+					.EndDict()
+					.EndDict().Build()
+				);
+			}
+
+			void DataBaseIOHandler::PrintNotFound(const int id) {
+				using namespace std::literals::string_literals;
+				answer_.push_back(json::Builder{}.StartDict()
+						.Key("request_id"s).Value(id)
+						.Key("error_message"s).Value("not found"s)
+					.EndDict().Build()
+				);
+			}
+
+			void DataBaseIOHandler::PrintRouteInfo(const details::RouteInfo& info, const int id) {
+				using namespace std::literals::string_literals;
+				answer_.push_back(json::Builder{}.StartDict()
+						.Key("request_id"s).Value(id)
+						.Key("route_length"s).Value(static_cast<int>(info.distance_total))
+						.Key("stop_count"s).Value(static_cast<int>(info.stops_count))
+						.Key("unique_stop_count"s).Value(static_cast<int>(info.unique_stops_count))
+						.Key("curvature"s).Value(static_cast<double>(info.curvature))
+					.EndDict().Build()
+				);
+			}
+
+			void DataBaseIOHandler::PrintRouterBuildedInfo(
+				const transport_router::RouteInfoPtr& info
+				, const int id
+			) {
+				using namespace std::literals::string_literals;
+				if (!info) {
+					PrintNotFound(id);
+					return;
+				}
+
+				answer_.push_back(json::Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("total_time"s).Value(info->total_time)
+					.Key("items"s).Value(MakeRouteItems(*info))
+					.EndDict().Build()
+				);
+			}
+
+			json::Array DataBaseIOHandler::MakeRouteItems(const transport_router::RouteInfo& info) const {
+				using namespace std::literals::string_literals;
+				json::Array items;
+				for (const auto& item : info.items) {
+					if (const auto wait_item = std::get_if<transport_router::WaitItem>(&item.content)) {
+						items.push_back(
+							json::Dict{
+								{"type", json::Node("Wait"s)}
+								, {"stop_name", json::Node(static_cast<std::string>(wait_item->stop_name))}
+								, {"time", json::Node(static_cast<int>(wait_item->time))}
+							}
+						);
+					}
+
+					if (const auto bus_item = std::get_if<transport_router::BusItem>(&item.content)) {
+						items.push_back(
+							json::Dict{
+								{"type", json::Node("Bus"s)}
+								, {"bus", json::Node(static_cast<std::string>(bus_item->bus))}
+								, {"span_count", json::Node(static_cast<int>(bus_item->span_count))}
+								, {"time", json::Node(bus_item->time)}
+							}
+						);
+					}
+				}
+
+				return items;
+			}
+
+			void DataBaseIOHandler::PrintReachableStops(
+				const std::vector<transport_router::ReachableStop>& stops
+				, const int id
+			) {
+				using namespace std::literals::string_literals;
+				json::Array stops_array;
+				for (const auto& stop : stops) {
+					stops_array.push_back(
+						json::Dict{
+							{"stop_name", json::Node(static_cast<std::string>(stop.stop_name))}
+							, {"time", json::Node(stop.time)}
+						}
+					);
+				}
+
+				answer_.push_back(json::Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("stops"s).Value(stops_array)
+					.EndDict().Build()
+				);
+			}
+
+			void DataBaseIOHandler::PrintTravelMatrix(
+				const transport_router::TravelMatrix& matrix
+				, const int id
+			) {
+				using namespace std::literals::string_literals;
+				json::Array times;
+				for (const auto& times_row : matrix.times) {
+					json::Array row;
+					row.reserve(times_row.size());
+					//the cells are built in place: a conditional of two temporary nodes makes
+					//gcc warn about the variant moved out of the branch it didn't take
+					for (const std::optional<double>& time : times_row) {
+						if (time) {
+							row.emplace_back(time.value());
+						}
+						else {
+							row.emplace_back(nullptr);
+						}
+					}
+					times.push_back(std::move(row));
+				}
+
+				if (matrix.routes.empty()) {
+					answer_.push_back(json::Builder{}.StartDict()
+						.Key("request_id"s).Value(id)
+						.Key("times"s).Value(times)
+						.EndDict().Build()
+					);
+					return;
+				}
+
+				json::Array routes;
+				for (const auto& routes_row : matrix.routes) {
+					json::Array row;
+					row.reserve(routes_row.size());
+					for (const transport_router::RouteInfoPtr& route : routes_row) {
+						if (route) {
+							row.emplace_back(MakeRouteItems(*route));
+						}
+						else {
+							row.emplace_back(nullptr);
+						}
+					}
+					routes.push_back(std::move(row));
+				}
+
+				answer_.push_back(json::Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("times"s).Value(times)
+					.Key("items"s).Value(routes)
+					.EndDict().Build()
+				);
+			}
+
+			DataBaseIOHandler::DataBaseIOHandler(CatalogueSnapshots* snapshots) {
+				snapshots_ = snapshots;//can't be represented with init-list, because is not base of DataBaseIOHandler
+				//the other fields are already initialized
+			}
+
+			void DataBaseIOHandler::ProcessIOQueries(const json::Node& node_ref) {
+				GetQueries(node_ref);
+				ExecuteQueries();
+				PrintAnswers();
+			}
+
+			size_t DataBaseIOHandler::GetQueries(const json::Node& node_ref) {
+				return input_reader_.ReadQueries(node_ref);
+			}
+
+			void DataBaseIOHandler::ExecuteQuery(Query& query) {
+				using namespace std::literals::string_literals;
+				switch (query.type) {
+				case QueryType::StopInfo:
+					if (const auto info{ catalogue_->GetStopInfo(std::get<StopInfoQueryContent>(query.content).name) }) {
+						PrintStopInfo(info.value(), query.id);
+					}
+					else {
+						PrintNotFound(query.id);
+					}
+					break;
+				case QueryType::RouteInfo:
+					//a route without the road distances has no stats and throws
+					try {
+						if (const auto info{ catalogue_->GetRouteInfo(std::get<RouteInfoQueryContent>(query.content).name) }) {
+							PrintRouteInfo(info.value(), query.id);
+						}
+						else {
+							PrintNotFound(query.id);
+						}
+					}
+					catch (std::logic_error&) {
+						PrintNotFound(query.id);
+					}
+					break;
+				case QueryType::BuildRoute:
+				{
+					transport_router::RouteInfoPtr route_info{ std::move(prefetched_routes_.front()) };
+					prefetched_routes_.pop_front();
+					PrintRouterBuildedInfo(route_info, query.id);
+				}
+					break;
+				case QueryType::Matrix:
+				{
+					//the cells of an unknown stop are empty as the ones of a stop without routes
+					const auto& content{ std::get<MatrixQueryContent>(query.content) };
+					PrintTravelMatrix(catalogue_->GetTravelMatrix(
+							{ content.from.begin(), content.from.end() }
+							, { content.to.begin(), content.to.end() }
+							, content.with_items
+						)
+						, query.id
+					);
+					break;
+				}
+				case QueryType::Reachable:
+				{
+					//a known stop reaches itself at least
+					const auto& content{ std::get<ReachableQueryContent>(query.content) };
+					if (const auto stops{ catalogue_->GetReachableStops(content.from, content.max_time) }; !stops.empty()) {
+						PrintReachableStops(stops, query.id);
+					}
+					else {
+						PrintNotFound(query.id);
+					}
+					break;
+				}
+				case QueryType::Nearest:
+				{
+					const auto& content{ std::get<NearestQueryContent>(query.content) };
+					PrintNearestStops(catalogue_->FindNearestStops(content.location, content.count), content.location, query.id);
+					break;
+				}
+				case QueryType::StopsInBox:
+					PrintStopsInBox(catalogue_->FindStopsInBox(std::get<StopsInBoxQueryContent>(query.content).box), query.id);
+					break;
+				case QueryType::Update:
+				{
+					//the queries before the update are answered already, the ones after it pin the changed copy
+					const json::Node& base_requests{ std::get<UpdateQueryContent>(query.content).base_requests };
+					snapshots_->Update([&base_requests](TransportCatalogue& catalogue) {
+						configurator::json_io::DataBaseConfigurator configurator{ &catalogue };
+						configurator.ChangeCatalogue(base_requests);
+					});
+					answer_.push_back(json::Builder{}.StartDict()
+						.Key("request_id"s).Value(query.id)
+						.EndDict().Build()
+					);
+					break;
+				}
+				case QueryType::RouterStats:
+					//the routes of the requests up to the next update are built before the answers
+					//, so the counters take all of them in
+					PrintRouterStats(catalogue_->GetRouterSearchStats(), catalogue_->GetRouteCacheStats(), query.id);
+					break;
+				case QueryType::DrawMap:
+				{
+					std::ostringstream oss{};
+					catalogue_->RenderMap(oss);
+					answer_.push_back(json::Builder{}.StartDict()
+						.Key("request_id"s).Value(query.id)
+						.Key("map"s).Value(oss.str())
+						.EndDict().Build()
+					);
+					break;
+				}
+				default:
+					throw std::logic_error{ "DataBaseIOHandler::ExecuteQuery: Unknown query type!" };
+				}
+			}
+
+			void DataBaseIOHandler::PrintAnswers(std::ostream& output_stream) {
+				if (answer_.empty()) {
+					return;
+				}
+				json::Print(json::Document{ answer_ }, output_stream);
+			}
+		}//json_io
+	}//io_handler
+}//transport_catalogue
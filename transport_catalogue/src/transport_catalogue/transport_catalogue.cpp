@@ -1,179 +1,803 @@
-#include "transport_catalogue.hpp"
-
-namespace transport_catalogue
-{
-
-TransportCatalogue::~TransportCatalogue() {
-}
-
-void TransportCatalogue::AddStop(std::string&& name, geo::Coordinates&& location) {
-	std::unordered_set<std::string>::iterator it = unique_names_.insert(std::move(name)).first;
-	unique_stops_[std::string_view{ *it }] = details::Stop{ std::string_view{ *it }, std::move(location) };
-}
-
-void TransportCatalogue::AddRoute(std::string&& route_name, std::vector<std::string_view>&& stops_names) {
-	std::forward_list<details::Stop*> stops;
-	for (std::string_view stop_name : stops_names) {
-		auto it = unique_stops_.find(stop_name);
-		if (it == unique_stops_.end()) {
-			throw std::logic_error{ "DataBase::AddRoute: No such stop!" };
-		}
-		stops.push_front(&(it->second));
-	}
-	std::unordered_set<std::string>::iterator it = unique_names_.insert(std::move(route_name)).first;
-	unique_routes_[std::string_view{ *it }] = std::move(details::Route{ std::string_view{ *it }, std::move(stops) });
-	for (details::Stop* stop_ptr : unique_routes_[std::string_view{ *it }].stops) {
-		stops_to_routes_[stop_ptr->name].insert(&unique_routes_[std::string_view{ *it }]);
-	}
-}
-
-	const details::Stop& TransportCatalogue::GetStop(std::string_view name) const {
-		auto it{ unique_stops_.find(std::move(name)) };
-		if (it == unique_stops_.end()) {
-			throw std::logic_error{ "DataBase::GetStop: No such stop!" };
-		}
-		return it->second;
-	}
-
-	const details::Stop* TransportCatalogue::GetStopPtr(std::string_view name) const {
-		auto it{ unique_stops_.find(std::move(name)) };
-		if (it == unique_stops_.end()) {
-			throw std::logic_error{ "DataBase::GetStopPtr: No such stop!" };
-		}
-		return &(it->second);
-	}
-
-	size_t TransportCatalogue::GetStopsCount() const {
-		return unique_stops_.size();
-	}
-
-	const details::Route& TransportCatalogue::GetRoute(std::string_view name) const {
-		auto it{ unique_routes_.find(std::move(name)) };
-		if (it == unique_routes_.end()) {
-			throw std::logic_error{ "DataBase::GetRoute: No such route!" };
-		}
-		return it->second;
-	}
-
-
-	const details::RouteInfo& TransportCatalogue::GetRouteInfo(std::string_view name) {
-		auto route_info_it{ routes_info_.find(name) };
-		if (route_info_it == routes_info_.end()) {
-			return SaveNewRouteInfo(name);
-		}
-		return route_info_it->second;
-	}
-
-	details::RouteInfo& TransportCatalogue::SaveNewRouteInfo(std::string_view name)
-	{
-		auto route_it{ unique_routes_.find(name) };
-		if (route_it == unique_routes_.end()) {
-			throw std::logic_error{ "DataBase::SaveNewRouteInfo: No such route!" };
-		}
-
-		auto route_info = CreateRouteInfo(&(route_it->second));
-		routes_info_[route_it->first] = std::move(route_info);
-
-		return routes_info_[route_it->first];
-	}
-
-	[[nodiscard]] details::RouteInfo TransportCatalogue::CreateRouteInfo(const details::Route* route_ptr) {
-		const unsigned short stops_count{ static_cast<unsigned short>(std::distance(route_ptr->stops.begin()
-									, route_ptr->stops.end()))
-		};
-
-		size_t distance_total{ 0 };
-		details::Stop* stop_prev = nullptr;
-
-		std::unordered_set<void*> unique_stops;
-
-		for (details::Stop* stop_ptr : route_ptr->stops) {
-			unique_stops.insert(reinterpret_cast<void*>(stop_ptr));
-
-			if (!stop_prev) {
-				stop_prev = stop_ptr;
-				continue;
-			}
- 			distance_total += GetDistanceBetweenStops(stop_ptr, stop_prev);
-			stop_prev = stop_ptr;
-		}
-		const unsigned short unique_stops_count{ static_cast<unsigned short>(unique_stops.size()) };
-
-		double distance_total_geographical{ 0. };
-		auto it{ route_ptr->stops.begin() };
-		auto prev_it{ it };
-		it = std::next(it);
-		for (; it != route_ptr->stops.end();) {
-			distance_total_geographical += geo::ComputeDistance((*prev_it)->location, (*it)->location);
-			it = std::next(it);
-			prev_it = std::next(prev_it);
-		}
-
-		return details::RouteInfo{ route_ptr->name
-							, stops_count
-							, unique_stops_count
-							, distance_total
-							, static_cast<double>(distance_total) / distance_total_geographical
-		};
-	}
-
-	const details::StopInfo& TransportCatalogue::GetStopInfo(std::string_view name) {
-		auto stop_info_it{ stops_info_.find(name) };
-		if (stop_info_it == stops_info_.end()) {
-			return SaveNewStopInfo(name);
-		}
-		return stop_info_it->second;
-	}
-
-	details::StopInfo& TransportCatalogue::SaveNewStopInfo(std::string_view name)
-	{
-		auto stop_it{ unique_stops_.find(name) };
-		if (stop_it == unique_stops_.end()) {
-			throw std::logic_error{ "DataBase::SaveNewStopInfo: No such stop!" };
-		}
-
-		auto stop_info = CreateStopInfo(&(stop_it->second));
-		stops_info_[stop_it->first] = std::move(stop_info);
-
-		return stops_info_[stop_it->first];
-	}
-
-	[[nodiscard]] details::StopInfo TransportCatalogue::CreateStopInfo(const details::Stop* stop_ptr) {
-		std::unordered_set<details::Route*, details::RoutePtrHasher>* routes_ptrs{ &stops_to_routes_[stop_ptr->name] };
-		return details::StopInfo{ stop_ptr->name
-			, routes_ptrs
-		};
-	}
-
-	void TransportCatalogue::SetDistanceBetweenStops(
-		const details::Stop* const stop_from
-		, const details::Stop* const stop_to
-		, unsigned long distance
-	) {
-		distance_graph_[{ stop_from, stop_to }] = distance;
-		if (distance_graph_.find({ stop_to, stop_from }) == distance_graph_.end()) {
-			distance_graph_[{ stop_to, stop_from }] = distance;
-		}
-	}
-
-	unsigned long TransportCatalogue::GetDistanceBetweenStops(
-		const details::Stop* const stop_from
-		, const details::Stop* const stop_to
-	) const {
-		if (distance_graph_.find({ stop_to, stop_from }) == distance_graph_.end()) {
-			throw std::logic_error{"TtransportCatalogue::GetDistanceBetweenStops: No data presented!"};
-		}
-		return distance_graph_.at({ stop_from, stop_to });
-	}
-
-	void TransportCatalogue::InitRouter(Router::TransportRouterInitList&& init) {
-		router_.Init(std::move(init));
-	}
-
-	std::optional<const transport_router::RouteInfo* const> TransportCatalogue::BuildRoute(
-		std::string_view from
-		, std::string_view to
-	) {
-		return router_.GetRouteInfo(from, to);
-	}
+#include "transport_catalogue.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+
+#include "thread_pool.hpp"
+
+namespace transport_catalogue
+{
+	namespace
+	{
+		//the snapshot file is a header followed by the arrays, each one aligned for its type:
+		//names offsets and chars, stops locations, the routes of the stops, routes round trip flags
+		//, stops ranges and stats, routes stops and distances, the distances table
+		//, the seeds and slots of the stops and routes names indices and the stops spatial index
+		constexpr std::array<char, 8> SNAPSHOT_MAGIC{ 'T', 'C', 'C', 'A', 'T', 'A', 'L', 'G' };
+		constexpr uint32_t SNAPSHOT_VERSION{ 5 }; //2: the routes of the stops are sorted by the names, 3: the stops spatial index, 4: 32-bit stops counts
+			//, 5: the names indices hash with FNV-1a
+		//read with the other byte order on a platform of the other endianness
+		constexpr uint32_t SNAPSHOT_BYTE_ORDER{ 0x01020304 };
+
+		struct SnapshotHeader {
+			std::array<char, 8> magic;
+			uint32_t version;
+			uint32_t byte_order;
+			uint64_t layout;
+			uint64_t source_checksum;
+			uint64_t stops_count;
+			uint64_t routes_count;
+			uint64_t names_size;
+			uint64_t stops_routes_count;
+			uint64_t routes_stops_count;
+			uint64_t distances_rows_count;
+			uint64_t distances_count;
+			uint64_t stops_index_seeds_count;
+			uint64_t stops_index_slots_count;
+			uint64_t routes_index_seeds_count;
+			uint64_t routes_index_slots_count;
+			uint64_t stops_geo_index_count;
+		};
+
+		//the order of the bus lists in the answers
+		bool IsNameLess(std::string_view lhs, std::string_view rhs) {
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+
+		perfect_hash::NameIndex CreateNameIndex(const std::unordered_map<std::string_view, uint32_t>& ids) {
+			return perfect_hash::NameIndex{ { ids.begin(), ids.end() } };
+		}
+
+		//the offsets start at 0, don't decrease and end at the size of the array they divide
+		template <typename Offset>
+		bool IsValidOffsets(std::span<const Offset> offsets, size_t size) {
+			return !offsets.empty() && offsets.front() == 0 && offsets.back() == size
+				&& std::is_sorted(offsets.begin(), offsets.end());
+		}
+	}
+
+TransportCatalogue::~TransportCatalogue() {
+}
+
+void TransportCatalogue::AddStop(std::string_view name, geo::Coordinates location) {
+	CheckIsChangeable();
+	if (stops_ids_.contains(name)) {
+		MoveStop(name, location);
+		return;
+	}
+	name = names_.Intern(name);
+	stops_index_.reset();
+	stops_ids_[name] = static_cast<StopId>(stops_names_.size());
+	stops_names_.push_back(name);
+	stops_locations_.Mutable().push_back(location);
+	stops_routes_.emplace_back();
+	stops_geo_index_.reset();
+	if (is_finalized_) {
+		//a new stop has no routes yet, its range is empty
+		stops_routes_offsets_.Mutable().push_back(stops_routes_offsets_.back());
+	}
+}
+
+void TransportCatalogue::AddRoute(std::string_view route_name, std::vector<std::string_view>&& stops_names, bool is_round_trip) {
+	CheckIsChangeable();
+	std::vector<StopId> stops;
+	stops.reserve(stops_names.size());
+	for (std::string_view stop_name : stops_names) {
+		auto it = stops_ids_.find(stop_name);
+		if (it == stops_ids_.end()) {
+			throw std::logic_error{ "DataBase::AddRoute: No such stop!" };
+		}
+		stops.push_back(it->second);
+	}
+	if (routes_ids_.contains(route_name)) {
+		RemoveRoute(route_name);
+	}
+	route_name = names_.Intern(route_name);
+	routes_index_.reset();
+	const RouteId route{ static_cast<RouteId>(routes_names_.size()) };
+	routes_ids_[route_name] = route;
+	routes_names_.push_back(route_name);
+	routes_round_trips_.Mutable().push_back(is_round_trip);
+	routes_stats_.Mutable().push_back(RouteStats{});
+	for (const StopId stop : stops) {
+		std::vector<RouteId>& stop_routes{ stops_routes_[stop] };
+		if (!is_finalized_) {
+			//the route's ids are at the back of the list while it's filled, Finalize sorts the lists
+			if (stop_routes.empty() || stop_routes.back() != route) {
+				stop_routes.push_back(route);
+			}
+			continue;
+		}
+		auto route_it{ std::lower_bound(stop_routes.begin(), stop_routes.end(), route_name, [this](RouteId lhs, std::string_view name) {
+			return IsNameLess(routes_names_[lhs], name);
+		}) };
+		if (route_it == stop_routes.end() || *route_it != route) {
+			stop_routes.insert(route_it, route);
+		}
+	}
+	if (is_finalized_) {
+		FreezeStopsRoutes();
+	}
+	routes_ranges_.Mutable().push_back(StopsRange{ .begin = routes_stops_.size(), .end = routes_stops_.size() + stops.size() });
+	routes_stops_.Mutable().insert(routes_stops_.Mutable().end(), stops.begin(), stops.end());
+	routes_distances_.Mutable().resize(routes_stops_.size());
+	routes_geo_distances_.Mutable().resize(routes_stops_.size());
+	ComputeRouteDistances(route);
+	UpdateRouteInfo(route);
+	if (router_.IsInitialized()) {
+		router_.AddRoute(route);
+	}
+	if (renderer_.IsInitialized()) {
+		renderer_.AddRoute(CreateRenderRoute(route));
+	}
+}
+
+	void TransportCatalogue::RemoveRoute(std::string_view name) {
+		CheckIsChangeable();
+		const RouteId route{ GetRouteId(name) };
+		if (router_.IsInitialized()) {
+			router_.RemoveRoute(route);
+		}
+
+		for (const StopId stop : GetRouteStops(route)) {
+			std::erase(stops_routes_[stop], route);
+		}
+		if (is_finalized_) {
+			FreezeStopsRoutes();
+		}
+		//the name stays in names_: the router's answers still refer to it.
+		//The stops stay in the flat arrays unreferenced
+		routes_ranges_.Mutable()[route] = StopsRange{ .begin = 0, .end = 0 };
+		routes_stats_.Mutable()[route] = RouteStats{};
+		if (renderer_.IsInitialized()) {
+			renderer_.RemoveRoute(routes_names_[route]);
+		}
+		routes_ids_.erase(name);
+		routes_index_.reset();
+	}
+
+	void TransportCatalogue::MoveStop(std::string_view name, geo::Coordinates location) {
+		CheckIsChangeable();
+		const StopId stop{ GetStopId(name) };
+		stops_locations_.Mutable()[stop] = location;
+		stops_geo_index_.reset();
+
+		//the road distances don't depend on the location, so the routes of the router stay as they are
+		for (const RouteId route : GetStopRoutes(stop)) {
+			ComputeRouteDistances(route);
+			UpdateRouteInfo(route);
+			if (renderer_.IsInitialized()) {
+				renderer_.AddRoute(CreateRenderRoute(route));
+			}
+		}
+		if (router_.IsInitialized()) {
+			router_.UpdateStopLocation(stop);
+		}
+	}
+
+	void TransportCatalogue::UpdateDistanceBetweenStops(std::string_view from, std::string_view to, unsigned long distance) {
+		SetDistanceBetweenStops(GetStopId(from), GetStopId(to), distance);
+	}
+
+	string_interner::StringInterner& TransportCatalogue::GetNames() {
+		return names_;
+	}
+
+	TransportCatalogue::StopId TransportCatalogue::GetStopId(std::string_view name) const {
+		const std::optional<StopId> stop{ FindStopId(name) };
+		if (!stop) {
+			throw std::logic_error{ "DataBase::GetStopId: No such stop!" };
+		}
+		return stop.value();
+	}
+
+	TransportCatalogue::RouteId TransportCatalogue::GetRouteId(std::string_view name) const {
+		const std::optional<RouteId> route{ FindRouteId(name) };
+		if (!route) {
+			throw std::logic_error{ "DataBase::GetRouteId: No such route!" };
+		}
+		return route.value();
+	}
+
+	std::optional<TransportCatalogue::StopId> TransportCatalogue::FindStopId(std::string_view name) const {
+		if (stops_index_) {
+			return stops_index_->Find(name, stops_names_);
+		}
+		auto it{ stops_ids_.find(name) };
+		return it != stops_ids_.end() ? std::optional<StopId>{ it->second } : std::nullopt;
+	}
+
+	std::optional<TransportCatalogue::RouteId> TransportCatalogue::FindRouteId(std::string_view name) const {
+		if (routes_index_) {
+			return routes_index_->Find(name, routes_names_);
+		}
+		auto it{ routes_ids_.find(name) };
+		return it != routes_ids_.end() ? std::optional<RouteId>{ it->second } : std::nullopt;
+	}
+
+	size_t TransportCatalogue::GetStopsCount() const {
+		return stops_names_.size();
+	}
+
+	size_t TransportCatalogue::GetRoutesCount() const {
+		return routes_names_.size();
+	}
+
+	std::string_view TransportCatalogue::GetStopName(StopId stop) const {
+		return stops_names_[stop];
+	}
+
+	const geo::Coordinates& TransportCatalogue::GetStopLocation(StopId stop) const {
+		return stops_locations_[stop];
+	}
+
+	std::span<const TransportCatalogue::RouteId> TransportCatalogue::GetStopRoutes(StopId stop) const {
+		if (!is_finalized_) {
+			return stops_routes_[stop];
+		}
+		return std::span<const RouteId>{ stops_routes_ids_ }.subspan(stops_routes_offsets_[stop]
+			, stops_routes_offsets_[stop + 1] - stops_routes_offsets_[stop]);
+	}
+
+	std::string_view TransportCatalogue::GetRouteName(RouteId route) const {
+		return routes_names_[route];
+	}
+
+	bool TransportCatalogue::IsRoundTrip(RouteId route) const {
+		return routes_round_trips_[route] != 0;
+	}
+
+	std::span<const TransportCatalogue::StopId> TransportCatalogue::GetRouteStops(RouteId route) const {
+		return std::span<const StopId>{ routes_stops_ }.subspan(routes_ranges_[route].begin
+			, routes_ranges_[route].end - routes_ranges_[route].begin);
+	}
+
+	unsigned long TransportCatalogue::GetRouteDistance(RouteId route, size_t from_index, size_t to_index) const {
+		const size_t begin{ routes_ranges_[route].begin };
+		if (routes_distances_[begin + to_index] == NO_DISTANCE) {
+			throw std::logic_error{ "TransportCatalogue::GetRouteDistance: No data presented!" };
+		}
+		return routes_distances_[begin + to_index] - routes_distances_[begin + from_index];
+	}
+
+	void TransportCatalogue::ComputeRouteDistances(RouteId route) {
+		const auto [begin, end] = routes_ranges_[route];
+		if (begin == end) {
+			return;
+		}
+		std::vector<uint64_t>& distances{ routes_distances_.Mutable() };
+		std::vector<double>& geo_distances{ routes_geo_distances_.Mutable() };
+		distances[begin] = 0;
+		geo_distances[begin] = 0.;
+		for (size_t i = begin + 1; i < end; ++i) {
+			const std::optional<DistanceTable::Distance> step{ distances_.Find(routes_stops_[i - 1], routes_stops_[i]) };
+			distances[i] = step && distances[i - 1] != NO_DISTANCE
+				? distances[i - 1] + step.value()
+				: NO_DISTANCE;
+			geo_distances[i] = geo_distances[i - 1]
+				+ geo::ComputeDistance(stops_locations_[routes_stops_[i - 1]], stops_locations_[routes_stops_[i]]);
+		}
+	}
+
+	std::vector<TransportCatalogue::RouteId> TransportCatalogue::FindRoutesThrough(StopId stop_from, StopId stop_to) const {
+		std::vector<RouteId> routes;
+		const std::span<const RouteId> routes_to{ GetStopRoutes(stop_to) };
+		for (const RouteId route : GetStopRoutes(stop_from)) {
+			if (std::find(routes_to.begin(), routes_to.end(), route) != routes_to.end()) {
+				routes.push_back(route);
+			}
+		}
+		return routes;
+	}
+
+	void TransportCatalogue::Finalize(size_t threads_count) {
+		CheckIsChangeable();
+		distances_.Freeze();
+		if (is_finalized_) {
+			//the changes kept the stats and the routes of the stops up to date, only the dropped indices are built
+			BuildIndices();
+			return;
+		}
+
+		//the answers list the buses by the names, so the lists are sorted once here and kept sorted by the changes
+		for (std::vector<RouteId>& stop_routes : stops_routes_) {
+			std::sort(stop_routes.begin(), stop_routes.end(), [this](RouteId lhs, RouteId rhs) {
+				return IsNameLess(routes_names_[lhs], routes_names_[rhs]);
+			});
+		}
+		FreezeStopsRoutes();
+
+		//the writes go to the distinct elements of the vector taken before the tasks
+		std::vector<RouteStats>& routes_stats{ routes_stats_.Mutable() };
+		thread_pool::ThreadPool pool{ threads_count };
+		pool.ParallelFor(routes_stats.size(), [this, &routes_stats](size_t route) {
+			if (routes_ranges_[route].begin == routes_ranges_[route].end) {
+				return;
+			}
+			try {
+				routes_stats[route] = CreateRouteStats(CreateRouteInfo(static_cast<RouteId>(route)));
+			}
+			catch (const std::logic_error&) {
+				//a route without the road distances has no stats, its queries throw as before
+			}
+		});
+
+		BuildIndices();
+		is_finalized_ = true;
+	}
+
+	void TransportCatalogue::BuildIndices() {
+		if (!stops_index_) {
+			stops_index_ = CreateNameIndex(stops_ids_);
+		}
+		if (!routes_index_) {
+			routes_index_ = CreateNameIndex(routes_ids_);
+		}
+		if (!stops_geo_index_) {
+			stops_geo_index_.emplace(stops_locations_);
+		}
+	}
+
+	bool TransportCatalogue::IsFinalized() const {
+		return is_finalized_;
+	}
+
+	std::unique_ptr<TransportCatalogue> TransportCatalogue::Clone() const {
+		auto clone{ std::make_unique<TransportCatalogue>() };
+		//the names are interned anew, a removed route keeps its name but not its id
+		clone->stops_names_.reserve(stops_names_.size());
+		for (StopId stop = 0; stop < stops_names_.size(); ++stop) {
+			clone->stops_names_.push_back(clone->names_.Intern(stops_names_[stop]));
+			clone->stops_ids_[clone->stops_names_.back()] = stop;
+		}
+		clone->routes_names_.reserve(routes_names_.size());
+		for (RouteId route = 0; route < routes_names_.size(); ++route) {
+			clone->routes_names_.push_back(clone->names_.Intern(routes_names_[route]));
+			if (FindRouteId(routes_names_[route]) == route) {
+				clone->routes_ids_[clone->routes_names_.back()] = route;
+			}
+		}
+
+		//a catalogue loaded from a snapshot has the frozen lists only
+		clone->stops_routes_.reserve(stops_names_.size());
+		for (StopId stop = 0; stop < stops_names_.size(); ++stop) {
+			const std::span<const RouteId> routes{ GetStopRoutes(stop) };
+			clone->stops_routes_.emplace_back(routes.begin(), routes.end());
+		}
+
+		//the copies of the arrays own their values, the viewed ones are copied out of the file
+		clone->stops_locations_ = stops_locations_;
+		clone->stops_routes_offsets_ = stops_routes_offsets_;
+		clone->stops_routes_ids_ = stops_routes_ids_;
+		clone->routes_round_trips_ = routes_round_trips_;
+		clone->routes_ranges_ = routes_ranges_;
+		clone->routes_stops_ = routes_stops_;
+		clone->routes_distances_ = routes_distances_;
+		clone->routes_geo_distances_ = routes_geo_distances_;
+		clone->routes_stats_ = routes_stats_;
+		clone->stops_index_ = stops_index_;
+		clone->routes_index_ = routes_index_;
+		clone->stops_geo_index_ = stops_geo_index_;
+		clone->distances_ = distances_;
+		clone->is_finalized_ = is_finalized_;
+
+		//the map refers to the names, so it's drawn again of the copy
+		if (renderer_.IsInitialized()) {
+			clone->SetRenderSettings(svg_renderer::RenderSettings{ renderer_.GetSettings() });
+		}
+		if (router_.IsInitialized()) {
+			clone->router_.InitCopy(router_, clone.get());
+		}
+		return clone;
+	}
+
+	std::optional<details::RouteInfo> TransportCatalogue::GetRouteInfo(std::string_view name) const {
+		const std::optional<RouteId> route{ FindRouteId(name) };
+		if (!route) {
+			return std::nullopt;
+		}
+		const RouteStats& stats{ routes_stats_[*route] };
+		if (!stats.is_computed) {
+			return CreateRouteInfo(*route);
+		}
+		return details::RouteInfo{ routes_names_[*route]
+							, stats.stops_count
+							, stats.unique_stops_count
+							, stats.distance_total
+							, stats.curvature
+		};
+	}
+
+	void TransportCatalogue::UpdateRouteInfo(RouteId route) {
+		routes_stats_.Mutable()[route] = RouteStats{};
+		if (is_finalized_) {
+			try {
+				routes_stats_.Mutable()[route] = CreateRouteStats(CreateRouteInfo(route));
+			}
+			catch (const std::logic_error&) {
+				//no stats for a route without the road distances, as in Finalize
+			}
+		}
+	}
+
+	TransportCatalogue::RouteStats TransportCatalogue::CreateRouteStats(const details::RouteInfo& info) {
+		return RouteStats{ .distance_total = info.distance_total
+						, .curvature = info.curvature
+						, .stops_count = info.stops_count
+						, .unique_stops_count = info.unique_stops_count
+						, .is_computed = 1
+		};
+	}
+
+	void TransportCatalogue::FreezeStopsRoutes() {
+		std::vector<uint32_t>& offsets{ stops_routes_offsets_.Mutable() };
+		std::vector<RouteId>& ids{ stops_routes_ids_.Mutable() };
+		offsets.assign(1, 0);
+		offsets.reserve(stops_routes_.size() + 1);
+		ids.clear();
+		for (const std::vector<RouteId>& routes : stops_routes_) {
+			ids.insert(ids.end(), routes.begin(), routes.end());
+			offsets.push_back(static_cast<uint32_t>(ids.size()));
+		}
+	}
+
+	void TransportCatalogue::CheckIsChangeable() const {
+		if (snapshot_mapping_) {
+			throw std::logic_error{ "TransportCatalogue: A catalogue loaded from a snapshot can't be changed!" };
+		}
+	}
+
+	uint64_t TransportCatalogue::GetSnapshotLayout() {
+		return sizeof(geo::Coordinates)
+			| sizeof(StopsRange) << 8
+			| sizeof(RouteStats) << 16
+			| sizeof(DistanceTable::Arc) << 24
+			| uint64_t{ sizeof(perfect_hash::NameIndex::Slot) } << 32
+			| uint64_t{ sizeof(geo_index::GeoIndex::Node) } << 40;
+	}
+
+	[[nodiscard]] details::RouteInfo TransportCatalogue::CreateRouteInfo(RouteId route) const {
+		const std::span<const StopId> stops{ GetRouteStops(route) };
+		const uint32_t stops_count{ static_cast<uint32_t>(stops.size()) };
+
+		const size_t distance_total{ stops.empty() ? 0 : GetRouteDistance(route, 0, stops.size() - 1) };
+		const double distance_total_geographical{ stops.empty() ? 0. : routes_geo_distances_[routes_ranges_[route].end - 1] };
+
+		std::vector<StopId> unique_stops{ stops.begin(), stops.end() };
+		std::sort(unique_stops.begin(), unique_stops.end());
+		const uint32_t unique_stops_count{ static_cast<uint32_t>(
+			std::unique(unique_stops.begin(), unique_stops.end()) - unique_stops.begin())
+		};
+
+		return details::RouteInfo{ routes_names_[route]
+							, stops_count
+							, unique_stops_count
+							, distance_total
+							, static_cast<double>(distance_total) / distance_total_geographical
+		};
+	}
+
+	std::optional<details::StopInfo> TransportCatalogue::GetStopInfo(std::string_view name) const {
+		const std::optional<StopId> stop{ FindStopId(name) };
+		if (!stop) {
+			return std::nullopt;
+		}
+		return details::StopInfo{ stops_names_[*stop], GetStopRoutes(*stop) };
+	}
+
+	std::vector<TransportCatalogue::StopId> TransportCatalogue::FindNearestStops(geo::Coordinates point, size_t count) const {
+		if (stops_geo_index_) {
+			return stops_geo_index_->FindNearest(point, count);
+		}
+		return geo_index::GeoIndex{ stops_locations_ }.FindNearest(point, count);
+	}
+
+	std::vector<TransportCatalogue::StopId> TransportCatalogue::FindStopsInBox(const geo_index::GeoIndex::Box& box) const {
+		std::vector<StopId> stops{ stops_geo_index_
+			? stops_geo_index_->FindInBox(box)
+			: geo_index::GeoIndex{ stops_locations_ }.FindInBox(box)
+		};
+		std::sort(stops.begin(), stops.end(), [this](StopId lhs, StopId rhs) {
+			return IsNameLess(stops_names_[lhs], stops_names_[rhs]);
+		});
+		return stops;
+	}
+
+	void TransportCatalogue::SetDistanceBetweenStops(StopId stop_from, StopId stop_to, unsigned long distance) {
+		CheckIsChangeable();
+		if (distance > std::numeric_limits<DistanceTable::Distance>::max()) {
+			throw std::out_of_range{ "TransportCatalogue::SetDistanceBetweenStops: The distance is too long to be kept!" };
+		}
+		distances_.Set(stop_from, stop_to, static_cast<DistanceTable::Distance>(distance));
+		//the distances are set before the routes while loading, the routes added already take the change here
+		if (stops_routes_[stop_from].empty()) {
+			return;
+		}
+		const std::vector<RouteId> routes{ FindRoutesThrough(stop_from, stop_to) };
+		for (const RouteId route : routes) {
+			ComputeRouteDistances(route);
+			UpdateRouteInfo(route);
+		}
+		if (router_.IsInitialized() && !routes.empty()) {
+			router_.UpdateRoutes(routes);
+		}
+	}
+
+	unsigned long TransportCatalogue::GetDistanceBetweenStops(StopId stop_from, StopId stop_to) const {
+		const std::optional<DistanceTable::Distance> distance{ distances_.Find(stop_from, stop_to) };
+		if (!distance) {
+			throw std::logic_error{"TtransportCatalogue::GetDistanceBetweenStops: No data presented!"};
+		}
+		return distance.value();
+	}
+
+	void TransportCatalogue::SaveSnapshot(const std::string& path, uint64_t source_checksum) const {
+		if (!is_finalized_) {
+			throw std::logic_error{ "TransportCatalogue::SaveSnapshot: The catalogue isn't finalized!" };
+		}
+
+		std::vector<uint64_t> names_offsets{ 0 };
+		names_offsets.reserve(stops_names_.size() + routes_names_.size() + 1);
+		std::string names_chars;
+		for (const auto* names : { &stops_names_, &routes_names_ }) {
+			for (std::string_view name : *names) {
+				names_chars += name;
+				names_offsets.push_back(names_chars.size());
+			}
+		}
+
+		//the indices dropped by the changes after Finalize are built for the file only
+		const perfect_hash::NameIndex stops_index{ stops_index_ ? *stops_index_ : CreateNameIndex(stops_ids_) };
+		const perfect_hash::NameIndex routes_index{ routes_index_ ? *routes_index_ : CreateNameIndex(routes_ids_) };
+		const geo_index::GeoIndex stops_geo_index{ stops_geo_index_ ? *stops_geo_index_ : geo_index::GeoIndex{ stops_locations_ } };
+		//so are the distances set after it
+		std::optional<DistanceTable> frozen_distances;
+		if (!distances_.IsFrozen()) {
+			frozen_distances.emplace(distances_).Freeze();
+		}
+		const DistanceTable& distances{ frozen_distances ? *frozen_distances : distances_ };
+		const std::span<const uint32_t> distances_offsets{ distances.GetOffsets() };
+		const std::span<const DistanceTable::Arc> distances_arcs{ distances.GetArcs() };
+
+		const SnapshotHeader header{
+			.magic = SNAPSHOT_MAGIC,
+			.version = SNAPSHOT_VERSION,
+			.byte_order = SNAPSHOT_BYTE_ORDER,
+			.layout = GetSnapshotLayout(),
+			.source_checksum = source_checksum,
+			.stops_count = stops_names_.size(),
+			.routes_count = routes_names_.size(),
+			.names_size = names_chars.size(),
+			.stops_routes_count = stops_routes_ids_.size(),
+			.routes_stops_count = routes_stops_.size(),
+			.distances_rows_count = distances_offsets.size() - 1,
+			.distances_count = distances_arcs.size(),
+			.stops_index_seeds_count = stops_index.GetSeeds().size(),
+			.stops_index_slots_count = stops_index.GetSlots().size(),
+			.routes_index_seeds_count = routes_index.GetSeeds().size(),
+			.routes_index_slots_count = routes_index.GetSlots().size(),
+			.stops_geo_index_count = stops_geo_index.GetSize()
+		};
+
+		//the file is written aside and renamed, so a process starting meanwhile never maps a partial one
+		const std::string temp_path{ path + ".tmp" };
+		{
+			std::ofstream output{ temp_path, std::ios::binary | std::ios::trunc };
+			mapped_file::ArraysWriter writer{ output };
+			writer.Write(header);
+			writer.Write(std::span<const uint64_t>{ names_offsets });
+			writer.Write(std::span<const char>{ names_chars });
+			writer.Write<geo::Coordinates>(stops_locations_);
+			writer.Write<uint32_t>(stops_routes_offsets_);
+			writer.Write<RouteId>(stops_routes_ids_);
+			writer.Write<uint8_t>(routes_round_trips_);
+			writer.Write<StopsRange>(routes_ranges_);
+			writer.Write<RouteStats>(routes_stats_);
+			writer.Write<StopId>(routes_stops_);
+			writer.Write<uint64_t>(routes_distances_);
+			writer.Write<double>(routes_geo_distances_);
+			writer.Write(distances_offsets);
+			writer.Write(distances_arcs);
+			writer.Write(stops_index.GetSeeds());
+			writer.Write(stops_index.GetSlots());
+			writer.Write(routes_index.GetSeeds());
+			writer.Write(routes_index.GetSlots());
+			writer.Write(stops_geo_index.GetNodes());
+			if (!output.flush()) {
+				throw std::logic_error{ "TransportCatalogue::SaveSnapshot: Can't write the snapshot file " + temp_path };
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_path, path, error);
+		if (error) {
+			throw std::logic_error{ "TransportCatalogue::SaveSnapshot: Can't replace the snapshot file " + path + ": " + error.message() };
+		}
+	}
+
+	uint64_t TransportCatalogue::LoadSnapshot(const std::string& path) {
+		if (!stops_names_.empty() || !routes_names_.empty() || snapshot_mapping_) {
+			throw std::logic_error{ "TransportCatalogue::LoadSnapshot: The catalogue isn't empty!" };
+		}
+		auto fail = [&path](const char* reason) {
+			return std::logic_error{ "TransportCatalogue::LoadSnapshot: " + path + ": " + reason };
+		};
+
+		std::optional<mapped_file::MappedFile> mapping{ mapped_file::MappedFile::Open(path) };
+		if (!mapping) {
+			throw fail("Can't open the file!");
+		}
+
+		mapped_file::ArraysReader reader{ mapping->GetData(), mapping->GetSize() };
+		const auto header_span{ reader.Read<SnapshotHeader>(1) };
+		if (!header_span) {
+			throw fail("Not a snapshot!");
+		}
+		const SnapshotHeader& header{ header_span->front() };
+		if (header.magic != SNAPSHOT_MAGIC) {
+			throw fail("Not a snapshot!");
+		}
+		if (header.version != SNAPSHOT_VERSION || header.byte_order != SNAPSHOT_BYTE_ORDER
+			|| header.layout != GetSnapshotLayout())
+		{
+			throw fail("The snapshot is of another version or platform!");
+		}
+		if (header.stops_count >= std::numeric_limits<StopId>::max()
+			|| header.routes_count >= std::numeric_limits<RouteId>::max()
+			|| header.distances_rows_count > header.stops_count)
+		{
+			throw fail("The snapshot is broken!");
+		}
+		const size_t stops_count{ static_cast<size_t>(header.stops_count) };
+		const size_t routes_count{ static_cast<size_t>(header.routes_count) };
+
+		const auto names_offsets{ reader.Read<uint64_t>(header.stops_count + header.routes_count + 1) };
+		const auto names_chars{ reader.Read<char>(header.names_size) };
+		const auto locations{ reader.Read<geo::Coordinates>(header.stops_count) };
+		const auto stops_routes_offsets{ reader.Read<uint32_t>(header.stops_count + 1) };
+		const auto stops_routes_ids{ reader.Read<RouteId>(header.stops_routes_count) };
+		const auto round_trips{ reader.Read<uint8_t>(header.routes_count) };
+		const auto ranges{ reader.Read<StopsRange>(header.routes_count) };
+		const auto stats{ reader.Read<RouteStats>(header.routes_count) };
+		const auto routes_stops{ reader.Read<StopId>(header.routes_stops_count) };
+		const auto routes_distances{ reader.Read<uint64_t>(header.routes_stops_count) };
+		const auto routes_geo_distances{ reader.Read<double>(header.routes_stops_count) };
+		const auto distances_offsets{ reader.Read<uint32_t>(header.distances_rows_count + 1) };
+		const auto distances_arcs{ reader.Read<DistanceTable::Arc>(header.distances_count) };
+		const auto stops_seeds{ reader.Read<uint32_t>(header.stops_index_seeds_count) };
+		const auto stops_slots{ reader.Read<perfect_hash::NameIndex::Slot>(header.stops_index_slots_count) };
+		const auto routes_seeds{ reader.Read<uint32_t>(header.routes_index_seeds_count) };
+		const auto routes_slots{ reader.Read<perfect_hash::NameIndex::Slot>(header.routes_index_slots_count) };
+		const auto geo_nodes{ reader.Read<geo_index::GeoIndex::Node>(header.stops_geo_index_count) };
+		if (!names_offsets || !names_chars || !locations || !stops_routes_offsets || !stops_routes_ids
+			|| !round_trips || !ranges || !stats || !routes_stops || !routes_distances || !routes_geo_distances
+			|| !distances_offsets || !distances_arcs || !stops_seeds || !stops_slots || !routes_seeds || !routes_slots || !geo_nodes)
+		{
+			throw fail("The snapshot is truncated!");
+		}
+
+		//the ids and ranges are checked, so a broken file can't send a query out of the arrays
+		auto is_valid_index = [](std::span<const uint32_t> seeds, std::span<const perfect_hash::NameIndex::Slot> slots, size_t ids_count) {
+			return (slots.empty() || !seeds.empty()) && slots.size() <= ids_count
+				&& std::all_of(slots.begin(), slots.end(), [ids_count](const auto& slot) { return slot.id < ids_count; });
+		};
+		if (!IsValidOffsets(*names_offsets, names_chars->size())
+			|| !IsValidOffsets(*stops_routes_offsets, stops_routes_ids->size())
+			|| !IsValidOffsets(*distances_offsets, distances_arcs->size())
+			|| !std::all_of(stops_routes_ids->begin(), stops_routes_ids->end(), [routes_count](RouteId route) { return route < routes_count; })
+			|| !std::all_of(routes_stops->begin(), routes_stops->end(), [stops_count](StopId stop) { return stop < stops_count; })
+			|| !std::all_of(distances_arcs->begin(), distances_arcs->end(), [stops_count](const DistanceTable::Arc& arc) { return arc.to < stops_count; })
+			|| !std::all_of(ranges->begin(), ranges->end(), [&routes_stops](const StopsRange& range) {
+					return range.begin <= range.end && range.end <= routes_stops->size();
+				})
+			|| !is_valid_index(*stops_seeds, *stops_slots, stops_count)
+			|| !is_valid_index(*routes_seeds, *routes_slots, routes_count)
+			|| geo_nodes->size() != stops_count
+			|| !std::all_of(geo_nodes->begin(), geo_nodes->end(), [stops_count](const geo_index::GeoIndex::Node& node) {
+					return node.id < stops_count && node.axis < 3;
+				}))
+		{
+			throw fail("The snapshot is broken!");
+		}
+
+		//the names are the one array made at load: the views of the names in the file
+		auto get_name = [&](size_t name_id) {
+			const uint64_t begin{ (*names_offsets)[name_id] };
+			return std::string_view{ names_chars->data() + begin, static_cast<size_t>((*names_offsets)[name_id + 1] - begin) };
+		};
+		stops_names_.reserve(stops_count);
+		for (size_t stop = 0; stop < stops_count; ++stop) {
+			stops_names_.push_back(get_name(stop));
+		}
+		routes_names_.reserve(routes_count);
+		for (size_t route = 0; route < routes_count; ++route) {
+			routes_names_.push_back(get_name(stops_count + route));
+		}
+
+		using mapped_file::MappedArray;
+		stops_locations_ = MappedArray<geo::Coordinates>::View(*locations);
+		stops_routes_offsets_ = MappedArray<uint32_t>::View(*stops_routes_offsets);
+		stops_routes_ids_ = MappedArray<RouteId>::View(*stops_routes_ids);
+		routes_round_trips_ = MappedArray<uint8_t>::View(*round_trips);
+		routes_ranges_ = MappedArray<StopsRange>::View(*ranges);
+		routes_stats_ = MappedArray<RouteStats>::View(*stats);
+		routes_stops_ = MappedArray<StopId>::View(*routes_stops);
+		routes_distances_ = MappedArray<uint64_t>::View(*routes_distances);
+		routes_geo_distances_ = MappedArray<double>::View(*routes_geo_distances);
+		distances_ = DistanceTable{ *distances_offsets, *distances_arcs };
+		stops_index_.emplace(*stops_seeds, *stops_slots);
+		routes_index_.emplace(*routes_seeds, *routes_slots);
+		stops_geo_index_.emplace(*geo_nodes);
+
+		snapshot_mapping_ = std::move(mapping);
+		is_finalized_ = true;
+		return header.source_checksum;
+	}
+
+	void TransportCatalogue::InitRouter(Router::TransportRouterInitList&& init) {
+		router_.Init(std::move(init));
+	}
+
+	transport_router::RouteInfoPtr TransportCatalogue::BuildRoute(
+		std::string_view from
+		, std::string_view to
+	) const {
+		return router_.GetRouteInfo(from, to);
+	}
+
+	std::vector<transport_router::RouteInfoPtr> TransportCatalogue::BuildRoutes(
+		const std::vector<transport_router::RouteRequest>& requests
+	) const {
+		return router_.GetRoutesInfo(requests);
+	}
+
+	std::vector<transport_router::ReachableStop> TransportCatalogue::GetReachableStops(
+		std::string_view from
+		, double max_time
+	) const {
+		return router_.GetReachableStops(from, max_time);
+	}
+
+	transport_router::TravelMatrix TransportCatalogue::GetTravelMatrix(
+		const std::vector<std::string_view>& from
+		, const std::vector<std::string_view>& to
+		, bool with_routes
+	) const {
+		return router_.GetTravelMatrix(from, to, with_routes);
+	}
+
+	::graph::IRouter<double>::SearchStats TransportCatalogue::GetRouterSearchStats() const {
+		return router_.IsInitialized() ? router_.GetSearchStats() : ::graph::IRouter<double>::SearchStats{};
+	}
+
+	lru_cache::CacheStats TransportCatalogue::GetRouteCacheStats() const {
+		return router_.IsInitialized() ? router_.GetRouteCacheStats() : lru_cache::CacheStats{};
+	}
+
+	void TransportCatalogue::SetRenderSettings(svg_renderer::RenderSettings&& settings) {
+		renderer_ = svg_renderer::Renderer{};
+		for (RouteId route = 0; route < routes_names_.size(); ++route) {
+			if (FindRouteId(routes_names_[route]) == route) { //a removed route keeps its name
+				renderer_.AddRoute(CreateRenderRoute(route));
+			}
+		}
+		renderer_.SetSettings(std::move(settings));
+	}
+
+	svg_renderer::RouteData TransportCatalogue::CreateRenderRoute(RouteId route) const {
+		svg_renderer::RouteData route_data{
+			.name = std::string{ routes_names_[route] },
+			.stops = {},
+			.is_round_trip = IsRoundTrip(route)
+		};
+		for (const StopId stop : GetRouteStops(route)) {
+			route_data.stops.push_back(svg_renderer::StopData{ stops_names_[stop], stops_locations_[stop] });
+		}
+		return route_data;
+	}
+
+	void TransportCatalogue::RenderMap(std::ostream& output_stream) const {
+		renderer_.Render(output_stream);
+	}
 }//transport_catalogue
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "geo_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace geo_index {
+
+    namespace {
+        using Node = GeoIndex::Node;
+        using Box = GeoIndex::Box;
+        using Candidate = std::pair<double, GeoIndex::Id>; // the squared distance and the id
+
+        void SetUnitVector(geo::Coordinates location, double (&point)[3]) {
+            constexpr double DEGREE = std::numbers::pi / 180.;
+            const double lat = location.lat * DEGREE;
+            const double lng = location.lng * DEGREE;
+            point[0] = std::cos(lat) * std::cos(lng);
+            point[1] = std::cos(lat) * std::sin(lng);
+            point[2] = std::sin(lat);
+        }
+
+        double ComputeSquaredDistance(const double (&lhs)[3], const double (&rhs)[3]) {
+            double distance = 0.;
+            for (size_t axis = 0; axis < 3; ++axis) {
+                distance += (lhs[axis] - rhs[axis]) * (lhs[axis] - rhs[axis]);
+            }
+            return distance;
+        }
+
+        // the node of the range [begin, end) of the array
+        size_t GetMiddle(size_t begin, size_t end) {
+            return begin + (end - begin) / 2;
+        }
+
+        void Build(std::vector<Node>& nodes, size_t begin, size_t end) {
+            if (begin >= end) {
+                return;
+            }
+
+            // the range is split across its longest side
+            uint32_t axis = 0;
+            double max_spread = -1.;
+            for (uint32_t candidate_axis = 0; candidate_axis < 3; ++candidate_axis) {
+                const auto [min_it, max_it] = std::minmax_element(nodes.begin() + begin, nodes.begin() + end
+                    , [candidate_axis](const Node& lhs, const Node& rhs) {
+                        return lhs.point[candidate_axis] < rhs.point[candidate_axis];
+                    });
+                if (const double spread = max_it->point[candidate_axis] - min_it->point[candidate_axis]; spread > max_spread) {
+                    max_spread = spread;
+                    axis = candidate_axis;
+                }
+            }
+
+            const size_t middle = GetMiddle(begin, end);
+            std::nth_element(nodes.begin() + begin, nodes.begin() + middle, nodes.begin() + end
+                , [axis](const Node& lhs, const Node& rhs) {
+                    return lhs.point[axis] < rhs.point[axis];
+                });
+            Build(nodes, begin, middle);
+            Build(nodes, middle + 1, end);
+
+            Node& node = nodes[middle];
+            node.axis = axis;
+            node.bounds = Box{ node.location.lat, node.location.lat, node.location.lng, node.location.lng };
+            for (const auto& [child_begin, child_end] : { std::pair{ begin, middle }, std::pair{ middle + 1, end } }) {
+                if (child_begin < child_end) {
+                    const Box& child_bounds = nodes[GetMiddle(child_begin, child_end)].bounds;
+                    node.bounds.min_lat = std::min(node.bounds.min_lat, child_bounds.min_lat);
+                    node.bounds.max_lat = std::max(node.bounds.max_lat, child_bounds.max_lat);
+                    node.bounds.min_lng = std::min(node.bounds.min_lng, child_bounds.min_lng);
+                    node.bounds.max_lng = std::max(node.bounds.max_lng, child_bounds.max_lng);
+                }
+            }
+        }
+
+        void SearchNearest(std::span<const Node> nodes, size_t begin, size_t end
+            , const double (&point)[3], size_t count, std::vector<Candidate>& heap)
+        {
+            if (begin >= end) {
+                return;
+            }
+
+            const size_t middle = GetMiddle(begin, end);
+            const Node& node = nodes[middle];
+            const Candidate candidate{ ComputeSquaredDistance(point, node.point), node.id };
+            if (heap.size() < count) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+
+            // the points beyond the splitting plane are at least as far as the plane
+            const double plane_distance = point[node.axis] - node.point[node.axis];
+            const bool is_before_plane = plane_distance < 0.;
+            SearchNearest(nodes, is_before_plane ? begin : middle + 1, is_before_plane ? middle : end, point, count, heap);
+            if (heap.size() < count || plane_distance * plane_distance <= heap.front().first) {
+                SearchNearest(nodes, is_before_plane ? middle + 1 : begin, is_before_plane ? end : middle, point, count, heap);
+            }
+        }
+
+        bool IsInBox(geo::Coordinates location, const Box& box) {
+            const bool is_lng_in_box = box.min_lng <= box.max_lng
+                ? box.min_lng <= location.lng && location.lng <= box.max_lng
+                : box.min_lng <= location.lng || location.lng <= box.max_lng;
+            return box.min_lat <= location.lat && location.lat <= box.max_lat && is_lng_in_box;
+        }
+
+        bool Intersects(const Box& bounds, const Box& box) {
+            const bool is_lng_crossed = box.min_lng <= box.max_lng
+                ? bounds.max_lng >= box.min_lng && bounds.min_lng <= box.max_lng
+                : bounds.max_lng >= box.min_lng || bounds.min_lng <= box.max_lng;
+            return bounds.max_lat >= box.min_lat && bounds.min_lat <= box.max_lat && is_lng_crossed;
+        }
+
+        bool Contains(const Box& box, const Box& bounds) {
+            const bool is_lng_inside = box.min_lng <= box.max_lng
+                ? bounds.min_lng >= box.min_lng && bounds.max_lng <= box.max_lng
+                : bounds.min_lng >= box.min_lng || bounds.max_lng <= box.max_lng;
+            return bounds.min_lat >= box.min_lat && bounds.max_lat <= box.max_lat && is_lng_inside;
+        }
+
+        void SearchBox(std::span<const Node> nodes, size_t begin, size_t end, const Box& box, std::vector<GeoIndex::Id>& ids) {
+            if (begin >= end) {
+                return;
+            }
+
+            const size_t middle = GetMiddle(begin, end);
+            const Node& node = nodes[middle];
+            if (!Intersects(node.bounds, box)) {
+                return;
+            }
+            if (Contains(box, node.bounds)) {
+                for (size_t index = begin; index < end; ++index) {
+                    ids.push_back(nodes[index].id);
+                }
+                return;
+            }
+
+            if (IsInBox(node.location, box)) {
+                ids.push_back(node.id);
+            }
+            SearchBox(nodes, begin, middle, box, ids);
+            SearchBox(nodes, middle + 1, end, box, ids);
+        }
+    }
+
+    GeoIndex::GeoIndex(std::span<const geo::Coordinates> locations) {
+        std::vector<Node>& nodes = nodes_.Mutable();
+        nodes.resize(locations.size());
+        for (size_t index = 0; index < locations.size(); ++index) {
+            SetUnitVector(locations[index], nodes[index].point);
+            nodes[index].location = locations[index];
+            nodes[index].id = static_cast<Id>(index);
+        }
+        Build(nodes, 0, nodes.size());
+    }
+
+    GeoIndex::GeoIndex(std::span<const Node> nodes)
+        : nodes_(mapped_file::MappedArray<Node>::View(nodes))
+    {
+    }
+
+    std::vector<GeoIndex::Id> GeoIndex::FindNearest(geo::Coordinates point, size_t count) const {
+        if (count == 0) {
+            return {};
+        }
+
+        double unit_point[3];
+        SetUnitVector(point, unit_point);
+
+        std::vector<Candidate> heap;
+        heap.reserve(std::min(count, nodes_.size()));
+        SearchNearest(nodes_, 0, nodes_.size(), unit_point, count, heap);
+        std::sort_heap(heap.begin(), heap.end());
+
+        std::vector<Id> ids;
+        ids.reserve(heap.size());
+        for (const auto& [distance, id] : heap) {
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    std::vector<GeoIndex::Id> GeoIndex::FindInBox(const Box& box) const {
+        std::vector<Id> ids;
+        SearchBox(nodes_, 0, nodes_.size(), box, ids);
+        return ids;
+    }
+
+    size_t GeoIndex::GetSize() const {
+        return nodes_.size();
+    }
+
+    std::span<const GeoIndex::Node> GeoIndex::GetNodes() const {
+        return nodes_;
+    }
+
+}  // namespace geo_index
@@ -0,0 +1,100 @@
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mapped_file {
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , is_mapped_(std::exchange(other.is_mapped_, false))
+        , buffer_(std::move(other.buffer_))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            is_mapped_ = std::exchange(other.is_mapped_, false);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    std::optional<MappedFile> MappedFile::Open(const std::string& path) {
+        MappedFile file;
+
+#ifdef MAPPED_FILE_USE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        file.size_ = static_cast<size_t>(file_stat.st_size);
+        if (file.size_ > 0) {
+            void* address = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                return std::nullopt;
+            }
+            file.data_ = static_cast<const std::byte*>(address);
+            file.is_mapped_ = true;
+        }
+        ::close(fd); //the mapping stays valid after the descriptor is closed
+#else
+        std::ifstream input{ path, std::ios::binary | std::ios::ate };
+        if (!input) {
+            return std::nullopt;
+        }
+        file.size_ = static_cast<size_t>(input.tellg());
+        file.buffer_.resize((file.size_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+        input.seekg(0);
+        if (!input.read(reinterpret_cast<char*>(file.buffer_.data()), static_cast<std::streamsize>(file.size_))) {
+            return std::nullopt;
+        }
+        file.data_ = reinterpret_cast<const std::byte*>(file.buffer_.data());
+#endif
+
+        return file;
+    }
+
+    const std::byte* MappedFile::GetData() const {
+        return data_;
+    }
+
+    size_t MappedFile::GetSize() const {
+        return size_;
+    }
+
+    void MappedFile::Close() {
+#ifdef MAPPED_FILE_USE_MMAP
+        if (is_mapped_) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        is_mapped_ = false;
+        buffer_.clear();
+    }
+
+}  // namespace mapped_file
@@ -0,0 +1,129 @@
+#include "perfect_hash.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace perfect_hash {
+
+    namespace {
+        constexpr size_t NAMES_PER_BUCKET = 3;
+        constexpr uint32_t MAX_SEED = 1 << 20; // far beyond the seeds distinct names need
+
+        // spreads the bits of the value over the whole word (the splitmix64 finalizer)
+        uint64_t Mix(uint64_t value) {
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+            return value ^ (value >> 31);
+        }
+
+        // the hashes are saved with the index, so they can't depend on the standard library
+        uint64_t HashFnv1a(std::string_view name) {
+            uint64_t hash = 14695981039346656037ull; // offset basis
+            for (const char c : name) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull; // prime
+            }
+            return hash;
+        }
+    }
+
+    NameIndex::NameIndex(const std::vector<std::pair<std::string_view, Id>>& entries) {
+        std::vector<uint32_t>& seeds = seeds_.Mutable();
+        std::vector<Slot>& slots = slots_.Mutable();
+        seeds.resize(entries.size() / NAMES_PER_BUCKET + 1, 0);
+        slots.resize(entries.size());
+
+        std::vector<uint64_t> hashes;
+        hashes.reserve(entries.size());
+        std::vector<std::vector<size_t>> buckets(seeds.size());
+        for (size_t index = 0; index < entries.size(); ++index) {
+            hashes.push_back(Hash(entries[index].first));
+            buckets[GetBucket(hashes.back())].push_back(index);
+        }
+
+        // the largest buckets are placed first, while the table is still mostly free
+        std::vector<size_t> buckets_order(buckets.size());
+        for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+            buckets_order[bucket] = bucket;
+        }
+        std::sort(buckets_order.begin(), buckets_order.end(), [&buckets](size_t lhs, size_t rhs) {
+            return buckets[lhs].size() > buckets[rhs].size();
+        });
+
+        std::vector<bool> taken(slots.size(), false);
+        std::vector<size_t> bucket_slots;
+        for (const size_t bucket : buckets_order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+            for (uint32_t seed = 1; ; ++seed) {
+                if (seed > MAX_SEED) {
+                    throw std::logic_error{ "perfect_hash::NameIndex: The names aren't distinct!" };
+                }
+                bucket_slots.clear();
+                for (const size_t index : buckets[bucket]) {
+                    const size_t slot = GetSlot(hashes[index], seed);
+                    if (taken[slot] || std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+                        break;
+                    }
+                    bucket_slots.push_back(slot);
+                }
+                if (bucket_slots.size() != buckets[bucket].size()) {
+                    continue;
+                }
+
+                seeds[bucket] = seed;
+                for (size_t i = 0; i < bucket_slots.size(); ++i) {
+                    const size_t index = buckets[bucket][i];
+                    taken[bucket_slots[i]] = true;
+                    slots[bucket_slots[i]] = Slot{ hashes[index], entries[index].second };
+                }
+                break;
+            }
+        }
+    }
+
+    NameIndex::NameIndex(std::span<const uint32_t> seeds, std::span<const Slot> slots)
+        : seeds_(mapped_file::MappedArray<uint32_t>::View(seeds))
+        , slots_(mapped_file::MappedArray<Slot>::View(slots))
+    {
+    }
+
+    std::optional<NameIndex::Id> NameIndex::Find(std::string_view name, std::span<const std::string_view> names) const {
+        if (slots_.empty()) {
+            return std::nullopt;
+        }
+
+        const uint64_t hash = Hash(name);
+        const Slot& slot = slots_[GetSlot(hash, seeds_[GetBucket(hash)])];
+        if (slot.hash != hash || names[slot.id] != name) {
+            return std::nullopt;
+        }
+        return slot.id;
+    }
+
+    size_t NameIndex::GetSize() const {
+        return slots_.size();
+    }
+
+    std::span<const uint32_t> NameIndex::GetSeeds() const {
+        return seeds_;
+    }
+
+    std::span<const NameIndex::Slot> NameIndex::GetSlots() const {
+        return slots_;
+    }
+
+    uint64_t NameIndex::Hash(std::string_view name) {
+        return Mix(HashFnv1a(name));
+    }
+
+    size_t NameIndex::GetBucket(uint64_t hash) const {
+        return (hash >> 32) % seeds_.size();
+    }
+
+    size_t NameIndex::GetSlot(uint64_t hash, uint32_t seed) const {
+        return Mix(hash + seed * 0x9e3779b97f4a7c15ull) % slots_.size();
+    }
+
+}  // namespace perfect_hash
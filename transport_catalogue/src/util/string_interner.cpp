@@ -0,0 +1,101 @@
+#include "string_interner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace string_interner {
+
+    namespace {
+        constexpr size_t MIN_SLOTS_COUNT = 64;
+    }
+
+    StringInterner::StringInterner(size_t block_size)
+        : block_size_(std::max<size_t>(block_size, 1))
+    {
+    }
+
+    std::string_view StringInterner::Intern(std::string_view str) {
+        // the table is kept at most half full
+        if ((strings_count_ + 1) * 2 > slots_.size()) {
+            Grow();
+        }
+
+        const size_t hash = std::hash<std::string_view>{}(str);
+        Slot& slot = const_cast<Slot&>(*FindSlot(str, hash));
+        if (!slot.data) {
+            slot = Slot{ hash, Store(str), str.size() };
+            ++strings_count_;
+        }
+        return { slot.data, slot.size };
+    }
+
+    std::optional<std::string_view> StringInterner::Find(std::string_view str) const {
+        if (slots_.empty()) {
+            return std::nullopt;
+        }
+
+        const Slot& slot = *FindSlot(str, std::hash<std::string_view>{}(str));
+        if (!slot.data) {
+            return std::nullopt;
+        }
+        return std::string_view{ slot.data, slot.size };
+    }
+
+    size_t StringInterner::GetStringsCount() const {
+        return strings_count_;
+    }
+
+    size_t StringInterner::GetBytesCount() const {
+        return bytes_count_;
+    }
+
+    // the slot of the string or the empty slot it would take, the table can't be full
+    const StringInterner::Slot* StringInterner::FindSlot(std::string_view str, size_t hash) const {
+        const size_t mask = slots_.size() - 1;
+        for (size_t index = hash & mask; ; index = (index + 1) & mask) {
+            const Slot& slot = slots_[index];
+            if (!slot.data || (slot.hash == hash && std::string_view{ slot.data, slot.size } == str)) {
+                return &slot;
+            }
+        }
+    }
+
+    const char* StringInterner::Store(std::string_view str) {
+        if (str.size() > block_size_) {
+            // a long string takes a block of its own, the current block stays in use
+            blocks_.push_back(std::make_unique_for_overwrite<char[]>(str.size()));
+            bytes_count_ += str.size();
+            std::memcpy(blocks_.back().get(), str.data(), str.size());
+            return blocks_.back().get();
+        }
+
+        if (!current_block_ || block_used_ + str.size() > block_size_) {
+            blocks_.push_back(std::make_unique_for_overwrite<char[]>(block_size_));
+            bytes_count_ += block_size_;
+            current_block_ = blocks_.back().get();
+            block_used_ = 0;
+        }
+        char* data = current_block_ + block_used_;
+        std::memcpy(data, str.data(), str.size());
+        block_used_ += str.size();
+        return data;
+    }
+
+    void StringInterner::Grow() {
+        std::vector<Slot> slots(std::max(slots_.size() * 2, MIN_SLOTS_COUNT));
+        const size_t mask = slots.size() - 1;
+        for (const Slot& slot : slots_) {
+            if (!slot.data) {
+                continue;
+            }
+            size_t index = slot.hash & mask;
+            while (slots[index].data) {
+                index = (index + 1) & mask;
+            }
+            slots[index] = slot;
+        }
+        slots_ = std::move(slots);
+    }
+
+}  // namespace string_interner
@@ -0,0 +1,108 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace thread_pool {
+
+    namespace {
+        thread_local const ThreadPool* current_pool = nullptr;
+    }
+
+    ThreadPool::ThreadPool(size_t threads_count) {
+        const size_t workers_count = std::max<size_t>(threads_count, 1) - 1;
+        workers_.reserve(workers_count);
+        for (size_t i = 0; i < workers_count; ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock{ mutex_ };
+            stopping_ = true;
+        }
+        work_available_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t ThreadPool::GetThreadsCount() const {
+        return workers_.size() + 1;
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task) {
+        if (count == 0) {
+            return;
+        }
+        if (workers_.empty() || count == 1 || current_pool == this) {
+            for (size_t index = 0; index < count; ++index) {
+                task(index);
+            }
+            return;
+        }
+
+        std::lock_guard loop_lock{ loop_mutex_ };
+        {
+            std::lock_guard lock{ mutex_ };
+            task_ = &task;
+            count_ = count;
+            next_index_.store(0);
+            busy_workers_ = workers_.size();
+            exception_ = nullptr;
+            ++generation_;
+        }
+        work_available_.notify_all();
+
+        const ThreadPool* outer_pool = std::exchange(current_pool, this);
+        RunTasks();
+        current_pool = outer_pool;
+
+        std::unique_lock lock{ mutex_ };
+        work_done_.wait(lock, [this] { return busy_workers_ == 0; });
+        task_ = nullptr;
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+    void ThreadPool::WorkerLoop() {
+        current_pool = this;
+        size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock lock{ mutex_ };
+                work_available_.wait(lock, [this, seen_generation] {
+                    return stopping_ || generation_ != seen_generation;
+                });
+                if (stopping_) {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+
+            RunTasks();
+
+            std::lock_guard lock{ mutex_ };
+            if (--busy_workers_ == 0) {
+                work_done_.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::RunTasks() {
+        for (size_t index = next_index_.fetch_add(1); index < count_; index = next_index_.fetch_add(1)) {
+            try {
+                (*task_)(index);
+            }
+            catch (...) {
+                std::lock_guard lock{ mutex_ };
+                if (!exception_) {
+                    exception_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+}  // namespace thread_pool
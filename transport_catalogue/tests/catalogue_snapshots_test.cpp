@@ -0,0 +1,70 @@
+#include <iostream>
+#include <memory>
+
+#include "catalogue_snapshots.hpp"
+#include "transport_catalogue.hpp"
+
+//the replaced snapshots are freed once no reader pins them
+namespace
+{
+	using transport_catalogue::CatalogueSnapshots;
+	using transport_catalogue::TransportCatalogue;
+
+	int failures_count{ 0 };
+
+	void Check(bool condition, const char* description) {
+		if (!condition) {
+			std::cerr << "FAILED: " << description << std::endl;
+			++failures_count;
+		}
+	}
+
+	std::shared_ptr<TransportCatalogue> MakeCatalogue() {
+		auto catalogue{ std::make_shared<TransportCatalogue>() };
+		catalogue->AddStop("A", { 55.60, 37.20 });
+		catalogue->AddStop("B", { 55.61, 37.21 });
+		catalogue->SetDistanceBetweenStops(catalogue->GetStopId("A"), catalogue->GetStopId("B"), 1000);
+		catalogue->AddRoute("1", { "A", "B" }, true);
+		catalogue->Finalize(1);
+		return catalogue;
+	}
+
+	void MoveStopB(TransportCatalogue& catalogue) {
+		catalogue.MoveStop("B", { 55.62, 37.22 });
+	}
+
+	void TestUpdateWithoutReaders() {
+		CatalogueSnapshots snapshots{ MakeCatalogue() };
+		std::weak_ptr<const TransportCatalogue> replaced{ snapshots.Pin() };
+
+		snapshots.Update(MoveStopB);
+		Check(replaced.expired(), "a snapshot no reader pins is freed by the update replacing it");
+		Check(snapshots.Reclaim() == 0, "no replaced snapshot is kept");
+		Check(snapshots.Pin()->GetStopLocation(snapshots.Pin()->GetStopId("B")).lat == 55.62
+			, "the readers pinning after the update see the change");
+	}
+
+	void TestUpdateWithReader() {
+		CatalogueSnapshots snapshots{ MakeCatalogue() };
+		CatalogueSnapshots::Snapshot reader{ snapshots.Pin() };
+		std::weak_ptr<const TransportCatalogue> replaced{ reader };
+
+		snapshots.Update(MoveStopB);
+		Check(!replaced.expired(), "a pinned snapshot outlives the update");
+		Check(reader->GetStopLocation(reader->GetStopId("B")).lat == 55.61, "the reader keeps the old data");
+		Check(snapshots.Reclaim() == 1, "the pinned snapshot is kept on the retired list");
+
+		reader.reset();
+		Check(snapshots.Reclaim() == 0, "nothing is kept once the reader unpins");
+		Check(replaced.expired(), "the snapshot is freed once the reader unpins");
+	}
+}
+
+int main() {
+	TestUpdateWithoutReaders();
+	TestUpdateWithReader();
+	if (failures_count == 0) {
+		std::cout << "catalogue_snapshots_test: OK" << std::endl;
+	}
+	return failures_count == 0 ? 0 : 1;
+}